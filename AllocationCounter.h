@@ -0,0 +1,15 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+// 全局 operator new 的调用计数。AllocationCounter.cpp 替换了全局的 new/delete，
+// 只链接进需要统计分配次数的程序（基准测试等），不放在 My2048Core 里
+namespace allocation {
+
+// 程序启动以来所有线程调用 operator new（含数组、对齐版本）的总次数
+std::uint64_t count();
+
+} // namespace allocation
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,243 @@
+#include "BatchRunner.h"
+#include "LargeBoard.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// 一个线程待做的对局编号 [begin, end)，两个 32 位端点打包在一个原子量里。
+// 线程自己从前端取，其他线程用 CAS 从后端切走一半
+class WorkRange {
+public:
+    void assign(std::uint32_t begin, std::uint32_t end) {
+        range.store(pack(begin, end), std::memory_order_release);
+    }
+
+    bool takeFront(std::uint32_t& index) {
+        std::uint64_t current = range.load(std::memory_order_acquire);
+        while (true) {
+            std::uint32_t begin = first(current);
+            std::uint32_t end = second(current);
+            if (begin >= end) {
+                return false;
+            }
+            if (range.compare_exchange_weak(current, pack(begin + 1, end), std::memory_order_acq_rel)) {
+                index = begin;
+                return true;
+            }
+        }
+    }
+
+    bool stealHalf(std::uint32_t& stolenBegin, std::uint32_t& stolenEnd) {
+        std::uint64_t current = range.load(std::memory_order_acquire);
+        while (true) {
+            std::uint32_t begin = first(current);
+            std::uint32_t end = second(current);
+            if (begin >= end) {
+                return false;
+            }
+            std::uint32_t middle = begin + (end - begin) / 2;
+            if (range.compare_exchange_weak(current, pack(begin, middle), std::memory_order_acq_rel)) {
+                stolenBegin = middle;
+                stolenEnd = end;
+                return true;
+            }
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> range{0};
+
+    static std::uint64_t pack(std::uint32_t begin, std::uint32_t end) {
+        return (static_cast<std::uint64_t>(begin) << 32) | end;
+    }
+    static std::uint32_t first(std::uint64_t value) { return static_cast<std::uint32_t>(value >> 32); }
+    static std::uint32_t second(std::uint64_t value) { return static_cast<std::uint32_t>(value); }
+};
+
+// 每个线程独占一个缓存行，避免伪共享
+struct alignas(64) Worker {
+    WorkRange work;
+    BatchStats stats;
+};
+
+template <class BoardType>
+bool chooseRandomMove(const BoardType& board, Rng& rng, Direction& best) {
+    std::array<Direction, 4> candidates;
+    int count = 0;
+    for (Direction dir : board.getDirections()) {
+        if (board.canMove(dir)) {
+            candidates[count++] = dir;
+        }
+    }
+    if (count == 0) {
+        return false;
+    }
+    best = candidates[rng.nextBelow(static_cast<std::uint32_t>(count))];
+    return true;
+}
+
+// chooseMove(board, playerRng, dir) 为当前局面选择方向。BoardType 为 Board，或菜单以外尺寸用的 LargeBoard（不记录）
+template <class BoardType, class ChooseMove>
+void playGame(const BatchOptions& options, ChooseMove&& chooseMove, std::uint32_t index, BatchStats& stats,
+              record::GameRecord* gameRecord) {
+    // 生成方块只用 rng，随机玩家另用一条流，这样按种子重放记录时只需复现生成
+    const std::uint64_t seed = Rng::streamSeed(options.seed, index);
+    Rng rng(seed);
+    Rng playerRng(Rng::streamSeed(seed, 1));
+    BoardType board(options.gridSize, options.version);
+    if (gameRecord) {
+        gameRecord->begin(options.gridSize, options.version, seed, options.recordSpawns);
+    }
+    auto spawn = [&]() {
+        const int cell = board.addRandomTile(rng);
+        if (gameRecord && cell >= 0) {
+            gameRecord->addSpawn(cell, board.getCell(cell));
+        }
+    };
+    spawn();
+    spawn();
+
+    std::uint64_t moves = 0;
+    while ((options.maxMoves == 0 || moves < options.maxMoves) && !board.isGameOver()) {
+        Direction dir;
+        if (!chooseMove(board, playerRng, dir) || !board.move(dir)) break;
+        if (gameRecord) {
+            gameRecord->addMove(dir);
+        }
+        spawn();
+        ++moves;
+    }
+
+    if constexpr (std::is_same_v<BoardType, Board>) {
+        if (gameRecord) {
+            gameRecord->finish(board);
+            options.recorder->write(*gameRecord);
+        }
+    }
+
+    stats.games += 1;
+    stats.wins += board.hasWon() ? 1 : 0;
+    stats.moves += moves;
+    stats.totalScore += static_cast<std::uint64_t>(board.getScore());
+    stats.bestScore = std::max(stats.bestScore, static_cast<std::uint64_t>(board.getScore()));
+    stats.maxTileCounts[std::min(board.getMaxExponent(), 31)] += 1;
+}
+
+void runWorker(const BatchOptions& options, std::vector<Worker>& workers, std::size_t self) {
+    std::unique_ptr<ExpectimaxPlayer> expectimax;
+    if (options.player == PlayerType::EXPECTIMAX) {
+        expectimax = std::make_unique<ExpectimaxPlayer>(options.search);
+    }
+    std::unique_ptr<NTuplePlayer> ntuple;
+    if (options.player == PlayerType::NTUPLE) {
+        ntuple = std::make_unique<NTuplePlayer>(*options.network);
+    }
+    std::unique_ptr<MonteCarloPlayer> montecarlo;
+    if (options.player == PlayerType::MONTECARLO) {
+        montecarlo = std::make_unique<MonteCarloPlayer>(options.rollout);
+    }
+    auto chooseMove = [&](const Board& board, Rng& playerRng, Direction& dir) {
+        if (expectimax) return expectimax->chooseMove(board, dir);
+        if (ntuple) return ntuple->chooseMove(board, dir);
+        if (montecarlo) {
+            // rollout 的随机数取自本局的玩家流，结果不受线程调度影响
+            montecarlo->reseed(playerRng.next());
+            return montecarlo->chooseMove(board, dir);
+        }
+        return chooseRandomMove(board, playerRng, dir);
+    };
+    auto chooseLargeMove = [](const LargeBoard& board, Rng& playerRng, Direction& dir) {
+        return chooseRandomMove(board, playerRng, dir);
+    };
+    const bool large = !movetable::supports(options.gridSize);
+
+    // 每个线程复用一份记录缓冲
+    record::GameRecord gameRecord;
+    record::GameRecord* recording = options.recorder ? &gameRecord : nullptr;
+
+    Worker& worker = workers[self];
+    while (true) {
+        std::uint32_t index;
+        if (worker.work.takeFront(index)) {
+            if (large) {
+                playGame<LargeBoard>(options, chooseLargeMove, index, worker.stats, nullptr);
+            } else {
+                playGame<Board>(options, chooseMove, index, worker.stats, recording);
+            }
+            continue;
+        }
+
+        // 自己的做完了，从下一个线程开始依次尝试偷一半
+        bool stole = false;
+        for (std::size_t offset = 1; offset < workers.size() && !stole; ++offset) {
+            std::uint32_t begin;
+            std::uint32_t end;
+            if (workers[(self + offset) % workers.size()].work.stealHalf(begin, end)) {
+                worker.work.assign(begin, end);
+                stole = true;
+            }
+        }
+        if (!stole) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+void BatchStats::merge(const BatchStats& other) {
+    games += other.games;
+    wins += other.wins;
+    moves += other.moves;
+    totalScore += other.totalScore;
+    bestScore = std::max(bestScore, other.bestScore);
+    for (std::size_t i = 0; i < maxTileCounts.size(); ++i) {
+        maxTileCounts[i] += other.maxTileCounts[i];
+    }
+}
+
+BatchStats runBatch(const BatchOptions& options) {
+    int threadCount = options.threads > 0 ? options.threads
+                                          : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threadCount = std::max(1, std::min(threadCount, std::max(1, options.games)));
+
+    if (movetable::supports(options.gridSize)) {
+        // 行表在所有线程间只读共享，先在主线程生成
+        movetable::table(options.gridSize, mergeRule(options.version));
+    } else if (options.gridSize < LargeBoard::MIN_SIZE || options.gridSize > LargeBoard::MAX_SIZE) {
+        throw std::invalid_argument("Unsupported grid size");
+    } else if (options.player != PlayerType::RANDOM || options.recorder) {
+        throw std::invalid_argument("Large boards support only the random player without recording");
+    }
+
+    std::vector<Worker> workers(threadCount);
+    const std::uint32_t games = static_cast<std::uint32_t>(std::max(0, options.games));
+    for (int i = 0; i < threadCount; ++i) {
+        workers[i].work.assign(static_cast<std::uint32_t>(std::uint64_t(games) * i / threadCount),
+                               static_cast<std::uint32_t>(std::uint64_t(games) * (i + 1) / threadCount));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(runWorker, std::cref(options), std::ref(workers), static_cast<std::size_t>(i));
+    }
+    runWorker(options, workers, 0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    BatchStats total;
+    for (const Worker& worker : workers) {
+        total.merge(worker.stats);
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
@@ -0,0 +1,51 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "Board.h"
+#include "Expectimax.h"
+#include "GameRecord.h"
+#include "MonteCarlo.h"
+#include "NTuple.h"
+#include <array>
+#include <cstdint>
+
+enum class PlayerType {
+    EXPECTIMAX,
+    RANDOM,
+    NTUPLE,
+    MONTECARLO
+};
+
+struct BatchOptions {
+    int gridSize = 4; // 4~6 用 Board；其余边长（2~64）用 LargeBoard，只支持随机玩家，不能记录
+    GameVersion version = GameVersion::ORIGINAL;
+    int games = 100;
+    std::uint64_t maxMoves = 0; // 每局最多走的步数，0 表示走到结束；大棋盘上的随机对局要走上百万步
+    int threads = 0; // 0 表示使用全部硬件线程
+    PlayerType player = PlayerType::EXPECTIMAX;
+    std::uint64_t seed = 0; // 第 i 局使用 Rng::streamSeed(seed, i)，与线程调度无关，可单独重放
+    ExpectimaxOptions search;
+    MonteCarloOptions rollout;                // MONTECARLO 玩家的参数；对局本身已按线程并行，threads 通常取 1
+    const NTupleNetwork* network = nullptr;   // NTUPLE 玩家使用的权重，边长需与 gridSize 一致
+    record::RecordWriter* recorder = nullptr; // 非空时把每一局写入对局记录
+    bool recordSpawns = false;                // 记录中附带每次生成的位置和数值
+};
+
+// 一批对局的汇总结果；每个线程各自累计，结束后再合并，不需要全局锁
+struct BatchStats {
+    std::uint64_t games = 0;
+    std::uint64_t wins = 0;   // 合成过 2048 的对局数（与 Game::gameWon 一致）
+    std::uint64_t moves = 0;
+    std::uint64_t totalScore = 0;
+    std::uint64_t bestScore = 0;
+    std::array<std::uint64_t, 32> maxTileCounts{}; // 按最大方块的指数统计
+    double seconds = 0.0;
+
+    void merge(const BatchStats& other);
+};
+
+// 在多个线程上自我对弈 options.games 局。对局编号按线程切成若干段，
+// 某个线程做完自己的那段后从其他线程剩余的段里偷一半，避免长对局让别的线程空等
+BatchStats runBatch(const BatchOptions& options);
+
+#endif // BATCHRUNNER_H
@@ -0,0 +1,419 @@
+#include "AllocationCounter.h"
+#include "Board.h"
+#include "LargeBoard.h"
+#include "Rng.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef MY2048_BENCH_RENDER
+#include "Game2048.h"
+#endif
+
+// 规则引擎各个热点的微基准：My2048Bench --min-time-ms 200 --json results.json
+namespace {
+
+// 每个语料库的对局数；早、中、晚期局面按每局走过的比例切成三段
+constexpr int CORPUS_GAMES = 32;
+constexpr int STAGE_COUNT = 3;
+const char* const STAGE_NAMES[STAGE_COUNT] = {"early", "mid", "late"};
+
+// 大棋盘：随机玩家走满 size*size*LARGE_MOVES_PER_CELL 步（大棋盘上随机对局很难走到结束），等间隔取 LARGE_SAMPLES 个局面
+constexpr int LARGE_SIZES[] = {16, 32, 64};
+constexpr int LARGE_GAMES = 4;
+constexpr int LARGE_MOVES_PER_CELL = 4;
+constexpr int LARGE_SAMPLES = 48;
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --filter TEXT      only run benchmarks whose name contains TEXT\n"
+                "  --min-time-ms N    minimum measuring time per benchmark (default 200)\n"
+                "  --seed N           corpus seed (default 1)\n"
+                "  --json FILE        also write the results as JSON\n"
+#ifdef MY2048_BENCH_RENDER
+                "  --render           also time game frames and input handling (opens a window)\n"
+#endif
+                , program);
+}
+
+struct BenchOptions {
+    std::string filter;
+    std::chrono::milliseconds minTime{200};
+    std::uint64_t seed = 1;
+    std::string jsonPath;
+    bool render = false;
+};
+
+struct Result {
+    std::string name;
+    int size;
+    GameVersion version;
+    int stage;
+    std::uint64_t ops;
+    double nsPerOp;
+    double allocationsPerOp;
+};
+
+const char* versionName(GameVersion version) {
+    switch (version) {
+        case GameVersion::ORIGINAL: return "original";
+        case GameVersion::MODIFIED: return "diagonal";
+        default:                    return "continuous";
+    }
+}
+
+// 固定种子的对局局面：贪心玩家（立即得分最高，平局随机）下到终局，记录每步之前的局面
+std::array<std::vector<Board>, STAGE_COUNT> buildCorpus(int size, GameVersion version, std::uint64_t seed) {
+    std::array<std::vector<Board>, STAGE_COUNT> stages;
+    for (int game = 0; game < CORPUS_GAMES; ++game) {
+        Rng rng(Rng::streamSeed(seed, static_cast<std::uint64_t>(game)));
+        Board board(size, version);
+        board.addRandomTile(rng);
+        board.addRandomTile(rng);
+
+        std::vector<Board> positions;
+        while (true) {
+            positions.push_back(board);
+            Board best;
+            int bestGain = -1;
+            const int offset = static_cast<int>(rng.nextBelow(4));
+            for (int j = 0; j < 4; ++j) {
+                Board child = board;
+                if (child.move(board.getDirections()[(offset + j) & 3])
+                    && child.getScore() - board.getScore() > bestGain) {
+                    bestGain = child.getScore() - board.getScore();
+                    best = child;
+                }
+            }
+            if (bestGain < 0) break;
+            board = best;
+            board.addRandomTile(rng);
+        }
+
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            stages[i * STAGE_COUNT / positions.size()].push_back(positions[i]);
+        }
+    }
+    return stages;
+}
+
+// 大棋盘的语料库：随机玩家（在能走的方向里均匀选）走固定步数，按步数切成早、中、晚三段
+std::array<std::vector<LargeBoard>, STAGE_COUNT> buildLargeCorpus(int size, GameVersion version, std::uint64_t seed) {
+    std::array<std::vector<LargeBoard>, STAGE_COUNT> stages;
+    const int moves = size * size * LARGE_MOVES_PER_CELL;
+    for (int game = 0; game < LARGE_GAMES; ++game) {
+        Rng rng(Rng::streamSeed(seed, static_cast<std::uint64_t>(game)));
+        LargeBoard board(size, version);
+        board.addRandomTile(rng);
+        board.addRandomTile(rng);
+
+        for (int move = 0; move < moves; ++move) {
+            if (move % (moves / LARGE_SAMPLES) == 0) {
+                stages[move * STAGE_COUNT / moves].push_back(board);
+            }
+            std::array<Direction, 4> candidates;
+            int count = 0;
+            for (Direction dir : board.getDirections()) {
+                if (board.canMove(dir)) candidates[count++] = dir;
+            }
+            if (count == 0) break;
+            board.move(candidates[rng.nextBelow(static_cast<std::uint32_t>(count))]);
+            board.addRandomTile(rng);
+        }
+    }
+    return stages;
+}
+
+// 对语料库反复执行 op 直到超过最短时间。op 的返回值累加后写入 sink，防止被优化掉；
+// 先跑一遍预热（生成行表等一次性分配不计入）
+volatile std::uint64_t sink = 0;
+
+template <class BoardType, class Op>
+Result measure(const BenchOptions& options, const char* name, int size, GameVersion version, int stage,
+               const std::vector<BoardType>& boards, int opsPerBoard, Op&& op) {
+    std::uint64_t checksum = 0;
+    for (const BoardType& board : boards) {
+        checksum += op(board);
+    }
+
+    std::uint64_t ops = 0;
+    const std::uint64_t allocationsBefore = allocation::count();
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    do {
+        for (const BoardType& board : boards) {
+            checksum += op(board);
+        }
+        ops += boards.size() * static_cast<std::uint64_t>(opsPerBoard);
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < options.minTime);
+    const std::uint64_t allocations = allocation::count() - allocationsBefore;
+    sink = checksum;
+
+    const double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count();
+    return {name, size, version, stage, ops, nanoseconds / ops, static_cast<double>(allocations) / ops};
+}
+
+void runBoardBenchmarks(const BenchOptions& options, int size, GameVersion version,
+                        const std::array<std::vector<Board>, STAGE_COUNT>& corpus,
+                        const std::function<bool(const char*)>& selected, std::vector<Result>& results) {
+    Rng rng(options.seed);
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        const std::vector<Board>& boards = corpus[stage];
+
+        // 每个局面四个方向各走一次（含拷贝棋盘）
+        if (selected("move")) {
+            results.push_back(measure(options, "move", size, version, stage, boards, 4, [](const Board& board) {
+                std::uint64_t moved = 0;
+                for (Direction dir : board.getDirections()) {
+                    Board child = board;
+                    moved += child.move(dir);
+                }
+                return moved;
+            }));
+        }
+        // GUI 的路径：同时记录每个方块的去向
+        if (selected("move_trace")) {
+            results.push_back(measure(options, "move_trace", size, version, stage, boards, 4, [](const Board& board) {
+                std::uint64_t merged = 0;
+                Board::MoveTrace trace;
+                for (Direction dir : board.getDirections()) {
+                    Board child = board;
+                    if (child.move(dir, &trace)) merged += trace.mergedMask;
+                }
+                return merged;
+            }));
+        }
+        if (selected("spawn")) {
+            results.push_back(measure(options, "spawn", size, version, stage, boards, 1, [&rng](const Board& board) {
+                Board child = board;
+                return static_cast<std::uint64_t>(child.addRandomTile(rng) + 1);
+            }));
+        }
+        if (selected("game_over")) {
+            results.push_back(measure(options, "game_over", size, version, stage, boards, 1, [](const Board& board) {
+                return static_cast<std::uint64_t>(board.isGameOver());
+            }));
+        }
+
+        // 4x4 原版的批量接口：整个语料库一次调用，按每个棋盘每个方向计一次
+        if (size == 4 && version == GameVersion::ORIGINAL && selected("move_batch")) {
+            std::vector<Bitboard> packed;
+            for (const Board& board : boards) {
+                Bitboard value;
+                if (board.toBitboard(value)) packed.push_back(value);
+            }
+            std::vector<Bitboard> moved(packed.size());
+            std::vector<std::uint32_t> scores(packed.size());
+            std::vector<std::uint8_t> flags(packed.size());
+            const std::vector<Board> once(1, boards.front());
+            Result result = measure(options, "move_batch", size, version, stage, once, 4 * static_cast<int>(packed.size()),
+                                    [&](const Board&) {
+                for (int d = 0; d < 4; ++d) {
+                    bitboard::moveBatch(packed.data(), packed.size(), static_cast<Direction>(d),
+                                        moved.data(), scores.data(), flags.data());
+                }
+                return static_cast<std::uint64_t>(moved[0]);
+            });
+            results.push_back(result);
+        }
+    }
+}
+
+// 大棋盘：拷贝到预先分配好的棋盘上再操作，拷贝复用已有的存储，allocs/op 应为 0
+void runLargeBenchmarks(const BenchOptions& options, int size, GameVersion version,
+                        const std::array<std::vector<LargeBoard>, STAGE_COUNT>& corpus,
+                        const std::function<bool(const char*)>& selected, std::vector<Result>& results) {
+    Rng rng(options.seed);
+    LargeBoard child(size, version);
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        const std::vector<LargeBoard>& boards = corpus[stage];
+        if (selected("move")) {
+            results.push_back(measure(options, "move", size, version, stage, boards, 4, [&](const LargeBoard& board) {
+                std::uint64_t moved = 0;
+                for (Direction dir : board.getDirections()) {
+                    child = board;
+                    moved += child.move(dir);
+                }
+                return moved;
+            }));
+        }
+        // 随机玩家每步的选择：四个方向各判断一次
+        if (selected("can_move")) {
+            results.push_back(measure(options, "can_move", size, version, stage, boards, 4, [](const LargeBoard& board) {
+                std::uint64_t movable = 0;
+                for (Direction dir : board.getDirections()) {
+                    movable += board.canMove(dir);
+                }
+                return movable;
+            }));
+        }
+        if (selected("spawn")) {
+            results.push_back(measure(options, "spawn", size, version, stage, boards, 1, [&](const LargeBoard& board) {
+                child = board;
+                return static_cast<std::uint64_t>(child.addRandomTile(rng) + 1);
+            }));
+        }
+        if (selected("game_over")) {
+            results.push_back(measure(options, "game_over", size, version, stage, boards, 1, [](const LargeBoard& board) {
+                return static_cast<std::uint64_t>(board.isGameOver());
+            }));
+        }
+    }
+}
+
+void printResults(const std::vector<Result>& results, std::size_t first) {
+    for (std::size_t i = first; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::printf("%-16s %4d %-9s %-6s %12.2f %12.4f\n", r.name.c_str(), r.size, versionName(r.version),
+                    STAGE_NAMES[r.stage], r.nsPerOp, r.allocationsPerOp);
+    }
+    std::fflush(stdout);
+}
+
+#ifdef MY2048_BENCH_RENDER
+// 每帧包括 window.display()；不限帧率、不开垂直同步
+void runRenderBenchmarks(const BenchOptions& options, Game& game, int size, GameVersion version,
+                         const std::array<std::vector<Board>, STAGE_COUNT>& corpus,
+                         const std::function<bool(const char*)>& selected, std::vector<Result>& results) {
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        // 一个阶段取一个代表局面，画面成本与局面关系不大
+        const std::vector<Board> position(1, corpus[stage][corpus[stage].size() / 2]);
+        if (selected("render")) {
+            results.push_back(measure(options, "render", size, version, stage, position, 1, [&](const Board& board) {
+                game.renderFrames(board, 1, false);
+                return std::uint64_t(1);
+            }));
+        }
+        if (selected("render_rebuild")) {
+            results.push_back(measure(options, "render_rebuild", size, version, stage, position, 1, [&](const Board& board) {
+                game.renderFrames(board, 1, true);
+                return std::uint64_t(1);
+            }));
+        }
+        // 按键到移动、生成、结束判断、update 的完整一步，不含渲染；allocs/op 应为 0
+        if (selected("input")) {
+            results.push_back(measure(options, "input", size, version, stage, corpus[stage], 1, [&](const Board& board) {
+                for (Direction dir : board.getDirections()) {
+                    if (game.playInput(board, dir)) return std::uint64_t(1);
+                }
+                return std::uint64_t(0);
+            }));
+        }
+    }
+}
+#endif
+
+bool parseArguments(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        }
+#ifdef MY2048_BENCH_RENDER
+        if (std::strcmp(arg, "--render") == 0) {
+            options.render = true;
+            continue;
+        }
+#endif
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--filter") == 0) {
+            options.filter = value;
+        } else if (std::strcmp(arg, "--min-time-ms") == 0) {
+            options.minTime = std::chrono::milliseconds(std::atoll(value));
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--json") == 0) {
+            options.jsonPath = value;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 每个结果一个对象，字段名固定，方便回归脚本比较前后两次的数字
+bool writeJson(const std::string& path, const BenchOptions& options, const std::vector<Result>& results) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "{\n  \"seed\": %llu,\n  \"kernel\": \"%s\",\n  \"results\": [\n",
+                 static_cast<unsigned long long>(options.seed), bitboard::batchKernel());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(file,
+                     "    {\"name\": \"%s\", \"size\": %d, \"version\": \"%s\", \"stage\": \"%s\", "
+                     "\"ops\": %llu, \"ns_per_op\": %.3f, \"allocations_per_op\": %.6f}%s\n",
+                     r.name.c_str(), r.size, versionName(r.version), STAGE_NAMES[r.stage],
+                     static_cast<unsigned long long>(r.ops), r.nsPerOp, r.allocationsPerOp,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    auto selected = [&](const char* name) {
+        return options.filter.empty() || std::string(name).find(options.filter) != std::string::npos;
+    };
+
+#ifdef MY2048_BENCH_RENDER
+    std::unique_ptr<Game> game;
+    if (options.render) {
+        DisplayOptions display;
+        display.frameLimit = 0;
+        game = std::make_unique<Game>(options.seed, display);
+        // 主菜单上不应有动画，否则空闲时主循环不会阻塞等待事件
+        if (game->isAnimating()) {
+            std::fprintf(stderr, "A new game window reports running animations before any game starts\n");
+            return 1;
+        }
+    }
+#endif
+
+    std::vector<Result> results;
+    std::printf("%-16s %4s %-9s %-6s %12s %12s\n", "benchmark", "size", "version", "stage", "ns/op", "allocs/op");
+    for (GameVersion version : {GameVersion::ORIGINAL, GameVersion::MODIFIED, GameVersion::CONTINUOUS}) {
+        for (int size = movetable::MIN_LENGTH; size <= movetable::MAX_LENGTH; ++size) {
+            const auto corpus = buildCorpus(size, version, options.seed);
+            const std::size_t first = results.size();
+            runBoardBenchmarks(options, size, version, corpus, selected, results);
+#ifdef MY2048_BENCH_RENDER
+            if (game) {
+                runRenderBenchmarks(options, *game, size, version, corpus, selected, results);
+            }
+#endif
+            printResults(results, first);
+        }
+        for (int size : LARGE_SIZES) {
+            const std::size_t first = results.size();
+            runLargeBenchmarks(options, size, version, buildLargeCorpus(size, version, options.seed), selected, results);
+            printResults(results, first);
+        }
+    }
+
+    if (!options.jsonPath.empty() && !writeJson(options.jsonPath, options, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", options.jsonPath.c_str());
+        return 1;
+    }
+    return 0;
+}
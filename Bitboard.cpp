@@ -0,0 +1,384 @@
+#include "Bitboard.h"
+#include "Symmetry.h"
+#include <bit>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MY2048_BATCH_AVX2 1
+#include <immintrin.h>
+#else
+#define MY2048_BATCH_AVX2 0
+#endif
+
+namespace bitboard {
+
+namespace {
+
+constexpr int ROW_COUNT = 1 << 16;
+
+std::uint16_t reverseRow(std::uint16_t row) {
+    return static_cast<std::uint16_t>(
+        (row >> 12) | ((row >> 4) & 0x00F0) | ((row << 4) & 0x0F00) | (row << 12));
+}
+
+// 所有 65536 种行状态的左移结果，右移通过翻转行复用同一张表。chain 为真时按连续合并规则生成
+struct RowTables {
+    std::array<std::uint16_t, ROW_COUNT> left;
+    std::array<std::uint16_t, ROW_COUNT> right;
+    std::array<std::uint32_t, ROW_COUNT> score;
+    std::array<std::uint32_t, ROW_COUNT> rightScore; // 右移的得分；连续合并时与左移不一定相同
+    std::array<std::uint8_t, ROW_COUNT> leftTargets; // 每个源格子左移后的目标列，2 bit 一格
+    // 批量查表用：低 16 位为结果行，高 16 位为得分 / 4（得分总是 4 的倍数，一行最多 65536），一次 gather 取回两者
+    std::array<std::uint32_t, ROW_COUNT> leftEntries;
+    std::array<std::uint32_t, ROW_COUNT> rightEntries;
+
+    explicit RowTables(bool chain) {
+        for (int row = 0; row < ROW_COUNT; ++row) {
+            int cells[4];
+            for (int i = 0; i < 4; ++i) {
+                cells[i] = (row >> (4 * i)) & 0xF;
+            }
+
+            // 与 Game::moveTiles 相同的规则：相邻相同方块合并，每个方块每次最多合并一次
+            int result[4] = {0, 0, 0, 0};
+            bool merged[4] = {false, false, false, false};
+            int target[4] = {0, 1, 2, 3};
+            int count = 0;
+            std::uint32_t gained = 0;
+            for (int i = 0; i < 4; ++i) {
+                if (cells[i] == 0) continue;
+                if (chain) {
+                    // 连续合并：放下后与前一格相同就并入前一格，已落在被并掉的格子上的方块跟着移过去
+                    result[count] = cells[i];
+                    target[i] = count++;
+                    while (count >= 2 && result[count - 1] == result[count - 2] && result[count - 1] < MAX_EXPONENT) {
+                        --count;
+                        ++result[count - 1];
+                        result[count] = 0;
+                        gained += 1u << result[count - 1];
+                        for (int j = 0; j <= i; ++j) {
+                            if (cells[j] != 0 && target[j] == count) target[j] = count - 1;
+                        }
+                    }
+                } else if (count > 0 && result[count - 1] == cells[i] && !merged[count - 1]
+                    && cells[i] < MAX_EXPONENT) {
+                    ++result[count - 1];
+                    merged[count - 1] = true;
+                    gained += 1u << result[count - 1];
+                    target[i] = count - 1;
+                } else {
+                    result[count] = cells[i];
+                    target[i] = count;
+                    ++count;
+                }
+            }
+
+            std::uint16_t packed = 0;
+            std::uint8_t targets = 0;
+            for (int i = 0; i < 4; ++i) {
+                packed |= static_cast<std::uint16_t>(result[i] << (4 * i));
+                targets |= static_cast<std::uint8_t>(target[i] << (2 * i));
+            }
+
+            left[row] = packed;
+            score[row] = gained;
+            leftTargets[row] = targets;
+        }
+
+        // 右移 = 翻转 -> 左移 -> 翻转
+        for (int row = 0; row < ROW_COUNT; ++row) {
+            std::uint16_t reversed = reverseRow(static_cast<std::uint16_t>(row));
+            right[row] = reverseRow(left[reversed]);
+            rightScore[row] = score[reversed];
+            leftEntries[row] = left[row] | ((score[row] >> 2) << 16);
+            rightEntries[row] = right[row] | ((score[reversed] >> 2) << 16);
+        }
+    }
+};
+
+const RowTables& tables() {
+    static const RowTables instance(false);
+    return instance;
+}
+
+const RowTables& chainTables() {
+    static const RowTables instance(true);
+    return instance;
+}
+
+Bitboard applyRows(Bitboard board, const std::array<std::uint16_t, ROW_COUNT>& table,
+                   const std::array<std::uint32_t, ROW_COUNT>& scores, int& score) {
+    Bitboard result = 0;
+    for (int y = 0; y < 4; ++y) {
+        std::uint16_t row = static_cast<std::uint16_t>(board >> (16 * y));
+        result |= static_cast<Bitboard>(table[row]) << (16 * y);
+        score += static_cast<int>(scores[row]);
+    }
+    return result;
+}
+
+MoveResult moveWith(const RowTables& t, Bitboard board, Direction dir) {
+    int score = 0;
+    Bitboard result = board;
+
+    switch (dir) {
+        case Direction::LEFT:  result = applyRows(board, t.left, t.score, score); break;
+        case Direction::RIGHT: result = applyRows(board, t.right, t.rightScore, score); break;
+        // 列移动：转置后按行处理再转置回来
+        case Direction::UP:    result = transpose(applyRows(transpose(board), t.left, t.score, score)); break;
+        case Direction::DOWN:  result = transpose(applyRows(transpose(board), t.right, t.rightScore, score)); break;
+        default: break;
+    }
+
+    return {result, score, result != board};
+}
+
+void slideTargetsWith(const RowTables& t, Bitboard board, Direction dir, std::array<std::uint8_t, 16>& targets) {
+    const bool vertical = (dir == Direction::UP || dir == Direction::DOWN);
+    const bool reversed = (dir == Direction::RIGHT || dir == Direction::DOWN);
+    Bitboard lines = vertical ? transpose(board) : board;
+
+    for (int line = 0; line < 4; ++line) {
+        std::uint16_t row = static_cast<std::uint16_t>(lines >> (16 * line));
+        std::uint8_t packed = t.leftTargets[reversed ? reverseRow(row) : row];
+        for (int i = 0; i < 4; ++i) {
+            // i 为沿移动方向的下标，翻转时映射回原始列
+            int from = reversed ? 3 - i : i;
+            int to = (packed >> (2 * i)) & 0x3;
+            if (reversed) to = 3 - to;
+            int fromCell = vertical ? 4 * from + line : 4 * line + from;
+            int toCell = vertical ? 4 * to + line : 4 * line + to;
+            targets[fromCell] = static_cast<std::uint8_t>(toCell);
+        }
+    }
+}
+
+// 把每个 nibble 折叠到最低位：nibble 为 0 时该位为 1
+constexpr Bitboard zeroNibbles(Bitboard board) {
+    board |= (board >> 2) & 0x3333333333333333ULL;
+    board |= (board >> 1);
+    return ~board & 0x1111111111111111ULL;
+}
+
+constexpr Bitboard NIBBLE_LOW = 0x1111111111111111ULL;
+constexpr Bitboard NOT_LAST_COLUMN = 0x0FFF0FFF0FFF0FFFULL; // 每行前三格
+constexpr Bitboard NOT_LAST_ROW = 0x0000FFFFFFFFFFFFULL;    // 前三行
+
+#if MY2048_BATCH_AVX2
+
+// 与 transpose 相同的位运算，4 个棋盘各占一个 64 位通道
+__attribute__((target("avx2"))) __m256i transposeLanes(__m256i board) {
+    const __m256i a1 = _mm256_and_si256(board, _mm256_set1_epi64x(static_cast<long long>(0xF0F00F0FF0F00F0FULL)));
+    const __m256i a2 = _mm256_and_si256(board, _mm256_set1_epi64x(0x0000F0F00000F0F0LL));
+    const __m256i a3 = _mm256_and_si256(board, _mm256_set1_epi64x(0x0F0F00000F0F0000LL));
+    const __m256i a = _mm256_or_si256(a1, _mm256_or_si256(_mm256_slli_epi64(a2, 12), _mm256_srli_epi64(a3, 12)));
+    const __m256i b1 = _mm256_and_si256(a, _mm256_set1_epi64x(static_cast<long long>(0xFF00FF0000FF00FFULL)));
+    const __m256i b2 = _mm256_and_si256(a, _mm256_set1_epi64x(0x00FF00FF00000000LL));
+    const __m256i b3 = _mm256_and_si256(a, _mm256_set1_epi64x(0x00000000FF00FF00LL));
+    return _mm256_or_si256(b1, _mm256_or_si256(_mm256_srli_epi64(b2, 24), _mm256_slli_epi64(b3, 24)));
+}
+
+__attribute__((target("avx2"))) __m256i zeroNibblesLanes(__m256i board) {
+    board = _mm256_or_si256(board, _mm256_and_si256(_mm256_srli_epi64(board, 2), _mm256_set1_epi64x(0x3333333333333333LL)));
+    board = _mm256_or_si256(board, _mm256_srli_epi64(board, 1));
+    return _mm256_andnot_si256(board, _mm256_set1_epi64x(static_cast<long long>(NIBBLE_LOW)));
+}
+
+// 每次处理 4 个棋盘：每行 16 位直接作为下标，用 gather 同时查 4 个棋盘同一行的结果和得分。返回处理到的位置
+__attribute__((target("avx2")))
+std::size_t moveBatchAvx2(const Bitboard* boards, std::size_t count, Direction dir,
+                          Bitboard* results, std::uint32_t* scores, std::uint8_t* moved) {
+    const RowTables& t = tables();
+    const bool vertical = dir == Direction::UP || dir == Direction::DOWN;
+    const int* entries = reinterpret_cast<const int*>(
+        dir == Direction::LEFT || dir == Direction::UP ? t.leftEntries.data() : t.rightEntries.data());
+    const __m256i rowMask = _mm256_set1_epi64x(0xFFFF);
+    const __m128i lowMask = _mm_set1_epi32(0xFFFF);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boards + i));
+        const __m256i lines = vertical ? transposeLanes(source) : source;
+        __m256i result = _mm256_setzero_si256();
+        __m128i score = _mm_setzero_si128();
+        for (int y = 0; y < 4; ++y) {
+            const __m128i shift = _mm_cvtsi32_si128(16 * y);
+            const __m256i index = _mm256_and_si256(_mm256_srl_epi64(lines, shift), rowMask);
+            const __m128i entry = _mm256_i64gather_epi32(entries, index, 4);
+            const __m256i row = _mm256_cvtepu32_epi64(_mm_and_si128(entry, lowMask));
+            result = _mm256_or_si256(result, _mm256_sll_epi64(row, shift));
+            score = _mm_add_epi32(score, _mm_srli_epi32(entry, 16));
+        }
+        if (vertical) {
+            result = transposeLanes(result);
+        }
+
+        const int same = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(result, source)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), result);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(scores + i), _mm_slli_epi32(score, 2));
+        for (int k = 0; k < 4; ++k) {
+            moved[i + k] = static_cast<std::uint8_t>(((same >> k) & 1) ^ 1);
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+std::size_t gameOverBatchAvx2(const Bitboard* boards, std::size_t count, std::uint8_t* over) {
+    const __m256i nibbleLow = _mm256_set1_epi64x(static_cast<long long>(NIBBLE_LOW));
+    const __m256i notLastColumn = _mm256_set1_epi64x(NOT_LAST_COLUMN);
+    const __m256i notLastRow = _mm256_set1_epi64x(NOT_LAST_ROW);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i board = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boards + i));
+        // 指数为 15 的格子（nibble 全 1）不参与合并
+        __m256i full = _mm256_and_si256(board, _mm256_srli_epi64(board, 1));
+        full = _mm256_and_si256(full, _mm256_srli_epi64(full, 2));
+        const __m256i mergeable = _mm256_andnot_si256(full, nibbleLow);
+
+        const __m256i right = _mm256_and_si256(zeroNibblesLanes(_mm256_xor_si256(board, _mm256_srli_epi64(board, 4))), notLastColumn);
+        const __m256i below = _mm256_and_si256(zeroNibblesLanes(_mm256_xor_si256(board, _mm256_srli_epi64(board, 16))), notLastRow);
+        const __m256i open = _mm256_or_si256(zeroNibblesLanes(board),
+                                             _mm256_and_si256(_mm256_or_si256(right, below), mergeable));
+
+        const int closed = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(open, _mm256_setzero_si256())));
+        for (int k = 0; k < 4; ++k) {
+            over[i + k] = static_cast<std::uint8_t>((closed >> k) & 1);
+        }
+    }
+    return i;
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#else
+
+std::size_t moveBatchAvx2(const Bitboard*, std::size_t, Direction, Bitboard*, std::uint32_t*, std::uint8_t*) {
+    return 0;
+}
+
+std::size_t gameOverBatchAvx2(const Bitboard*, std::size_t, std::uint8_t*) {
+    return 0;
+}
+
+bool hasAvx2() {
+    return false;
+}
+
+#endif
+
+} // namespace
+
+Bitboard transpose(Bitboard board) {
+    Bitboard a1 = board & 0xF0F00F0FF0F00F0FULL;
+    Bitboard a2 = board & 0x0000F0F00000F0F0ULL;
+    Bitboard a3 = board & 0x0F0F00000F0F0000ULL;
+    Bitboard a = a1 | (a2 << 12) | (a3 >> 12);
+    Bitboard b1 = a & 0xFF00FF0000FF00FFULL;
+    Bitboard b2 = a & 0x00FF00FF00000000ULL;
+    Bitboard b3 = a & 0x00000000FF00FF00ULL;
+    return b1 | (b2 >> 24) | (b3 << 24);
+}
+
+Bitboard flipX(Bitboard board) {
+    return ((board & 0x000F000F000F000FULL) << 12) | ((board & 0x00F000F000F000F0ULL) << 4)
+         | ((board >> 4) & 0x00F000F000F000F0ULL) | ((board >> 12) & 0x000F000F000F000FULL);
+}
+
+Bitboard flipY(Bitboard board) {
+    return (board << 48) | ((board & 0x00000000FFFF0000ULL) << 16)
+         | ((board >> 16) & 0x00000000FFFF0000ULL) | (board >> 48);
+}
+
+Bitboard applySymmetry(Bitboard board, int symmetry) {
+    if (symmetry & symmetry::TRANSPOSE) board = transpose(board);
+    if (symmetry & symmetry::FLIP_X) board = flipX(board);
+    if (symmetry & symmetry::FLIP_Y) board = flipY(board);
+    return board;
+}
+
+Bitboard canonicalize(Bitboard board, int& symmetry) {
+    // 下标与 Symmetry.h 的编号一致
+    const Bitboard t = transpose(board);
+    const Bitboard x = flipX(board);
+    const Bitboard tx = flipX(t);
+    const std::array<Bitboard, 8> images = {
+        board, x, flipY(board), flipY(x),
+        t, tx, flipY(t), flipY(tx)
+    };
+    symmetry = 0;
+    for (int s = 1; s < 8; ++s) {
+        if (images[s] < images[symmetry]) symmetry = s;
+    }
+    return images[symmetry];
+}
+
+int countEmpty(Bitboard board) {
+    return std::popcount(zeroNibbles(board));
+}
+
+std::uint16_t emptyMask(Bitboard board) {
+    board = zeroNibbles(board);
+    // 把第 4*c 位上的标志依次压紧到第 c 位
+    board = (board | (board >> 3)) & 0x0303030303030303ULL;
+    board = (board | (board >> 6)) & 0x000F000F000F000FULL;
+    board = (board | (board >> 12)) & 0x000000FF000000FFULL;
+    board = (board | (board >> 24)) & 0xFFFFULL;
+    return static_cast<std::uint16_t>(board);
+}
+
+MoveResult move(Bitboard board, Direction dir) {
+    return moveWith(tables(), board, dir);
+}
+
+MoveResult moveChain(Bitboard board, Direction dir) {
+    return moveWith(chainTables(), board, dir);
+}
+
+bool isGameOver(Bitboard board) {
+    // 有空格，或者横向、纵向相邻的两格相同且不是 15，就还能移动
+    Bitboard full = board & (board >> 1);
+    full &= full >> 2;
+    const Bitboard mergeable = ~full & NIBBLE_LOW;
+    const Bitboard right = zeroNibbles(board ^ (board >> 4)) & NOT_LAST_COLUMN;
+    const Bitboard below = zeroNibbles(board ^ (board >> 16)) & NOT_LAST_ROW;
+    return (zeroNibbles(board) | ((right | below) & mergeable)) == 0;
+}
+
+void moveBatch(const Bitboard* boards, std::size_t count, Direction dir,
+               Bitboard* results, std::uint32_t* scores, std::uint8_t* moved) {
+    std::size_t i = 0;
+    if (hasAvx2() && !isDiagonal(dir)) {
+        i = moveBatchAvx2(boards, count, dir, results, scores, moved);
+    }
+    for (; i < count; ++i) {
+        const MoveResult result = move(boards[i], dir);
+        results[i] = result.board;
+        scores[i] = static_cast<std::uint32_t>(result.score);
+        moved[i] = result.moved;
+    }
+}
+
+void gameOverBatch(const Bitboard* boards, std::size_t count, std::uint8_t* over) {
+    std::size_t i = hasAvx2() ? gameOverBatchAvx2(boards, count, over) : 0;
+    for (; i < count; ++i) {
+        over[i] = isGameOver(boards[i]);
+    }
+}
+
+const char* batchKernel() {
+    return hasAvx2() ? "avx2" : "scalar";
+}
+
+void slideTargets(Bitboard board, Direction dir, std::array<std::uint8_t, 16>& targets) {
+    slideTargetsWith(tables(), board, dir, targets);
+}
+
+void slideTargetsChain(Bitboard board, Direction dir, std::array<std::uint8_t, 16>& targets) {
+    slideTargetsWith(chainTables(), board, dir, targets);
+}
+
+} // namespace bitboard
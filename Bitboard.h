@@ -0,0 +1,63 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "Direction.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// 4x4 棋盘的压缩表示：每格 4 bit 存方块数值的 log2（0 表示空格），16 格塞进一个 uint64_t。
+// 第 y 行占第 16*y 位起的 16 位，行内第 x 格是其中第 x 个 nibble（低位在左）。
+using Bitboard = std::uint64_t;
+
+namespace bitboard {
+
+// 4 bit 能表示的最大指数（32768）。两个 32768 不再合并，更大的方块由 Board 按格子数组处理
+constexpr int MAX_EXPONENT = 15;
+
+struct MoveResult {
+    Bitboard board;
+    int score;   // 本次移动合并得到的分数
+    bool moved;
+};
+
+inline int getExponent(Bitboard board, int x, int y) {
+    return static_cast<int>((board >> (4 * (4 * y + x))) & 0xF);
+}
+
+Bitboard transpose(Bitboard board);
+Bitboard flipX(Bitboard board); // 左右翻转
+Bitboard flipY(Bitboard board); // 上下翻转
+// 按 Symmetry.h 的编号变换
+Bitboard applySymmetry(Bitboard board, int symmetry);
+// 8 个对称像中数值最小的一个作为等价类代表，symmetry 返回所用的变换：canonical = applySymmetry(board, symmetry)
+Bitboard canonicalize(Bitboard board, int& symmetry);
+int countEmpty(Bitboard board);
+// 空格位掩码：第 c 位为 1 表示格子 c（下标 4*y+x）为空
+std::uint16_t emptyMask(Bitboard board);
+
+// 查表完成一次上下左右移动；斜向不在压缩棋盘上处理，原样返回
+MoveResult move(Bitboard board, Direction dir);
+// 按连续合并规则移动（见 movetable::MergeRule::CHAIN）。表中两个 32768 不合并，
+// 调用方要保证棋盘上没有 >= 16384 的方块，否则结果可能需要超出 4 bit 的指数
+MoveResult moveChain(Bitboard board, Direction dir);
+
+// 上下左右都无法移动时返回 true；与 move 一致，两个 32768 不再合并
+bool isGameOver(Bitboard board);
+
+// 批量移动：boards[0..count) 全部走 dir，结果、得分和是否移动写入 results、scores、moved 的对应位置，
+// results 可以就是 boards。支持 AVX2 的 x86 CPU 上每次查表同时处理 4 个棋盘，否则逐个调用 move
+void moveBatch(const Bitboard* boards, std::size_t count, Direction dir,
+               Bitboard* results, std::uint32_t* scores, std::uint8_t* moved);
+// 批量判断结束，结果写入 over（1 表示结束）
+void gameOverBatch(const Bitboard* boards, std::size_t count, std::uint8_t* over);
+// 当前 CPU 上批量函数使用的实现："avx2" 或 "scalar"
+const char* batchKernel();
+
+// 记录移动前每个格子（下标 4*y+x）上的方块会滑到哪个格子，供 GUI 生成动画；空格保持原下标
+void slideTargets(Bitboard board, Direction dir, std::array<std::uint8_t, 16>& targets);
+void slideTargetsChain(Bitboard board, Direction dir, std::array<std::uint8_t, 16>& targets);
+
+} // namespace bitboard
+
+#endif // BITBOARD_H
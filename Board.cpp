@@ -0,0 +1,469 @@
+#include "Board.h"
+#include "Symmetry.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+struct SlowSlide {
+    std::array<int, movetable::MAX_LENGTH> result;
+    std::array<int, movetable::MAX_LENGTH> targets;
+    int score;
+    bool moved;
+};
+
+// 逐格左移一条线（第 0 格靠墙），用于行表覆盖不到的大方块（指数 >= 15），以及连续合并时的动画记录
+SlowSlide slideSlow(const std::array<int, movetable::MAX_LENGTH>& line, int length, movetable::MergeRule rule) {
+    SlowSlide slide{};
+    std::array<bool, movetable::MAX_LENGTH> merged{};
+    int count = 0;
+    for (int i = 0; i < length; ++i) {
+        slide.targets[i] = i;
+        if (line[i] == 0) continue;
+        if (rule == movetable::MergeRule::CHAIN) {
+            // 放下后与前一格相同就并入前一格，已经落在被并掉的格子上的方块跟着移过去
+            slide.result[count] = line[i];
+            slide.targets[i] = count++;
+            while (count >= 2 && slide.result[count - 1] == slide.result[count - 2]) {
+                --count;
+                ++slide.result[count - 1];
+                slide.result[count] = 0;
+                slide.score += 1 << slide.result[count - 1];
+                for (int j = 0; j <= i; ++j) {
+                    if (line[j] != 0 && slide.targets[j] == count) slide.targets[j] = count - 1;
+                }
+            }
+        } else if (count > 0 && slide.result[count - 1] == line[i] && !merged[count - 1]) {
+            ++slide.result[count - 1];
+            merged[count - 1] = true;
+            slide.score += 1 << slide.result[count - 1];
+            slide.targets[i] = count - 1;
+        } else {
+            slide.result[count] = line[i];
+            slide.targets[i] = count++;
+        }
+    }
+    for (int i = 0; i < length; ++i) {
+        slide.moved = slide.moved || slide.result[i] != line[i];
+    }
+    return slide;
+}
+
+} // namespace
+
+// 按边长和合并规则特化的规则实现：边长、每个方向的线数、每条线的长度和格子下标都是编译期常量，
+// 逐线处理在编译期展开，不再有按运行期 size 的循环。Board 构造时按边长和版本选定一次
+template <int Size, movetable::MergeRule Rule>
+struct SizedEngine {
+    static constexpr int CELLS = Size * Size;
+    static constexpr std::uint64_t FULL_MASK = (std::uint64_t(1) << CELLS) - 1;
+
+    template <Direction Dir>
+    static constexpr const movetable::LineLayout& layout() {
+        return movetable::LAYOUTS<Size>[static_cast<int>(Dir)];
+    }
+
+    // 依次对 Dir 方向的每条线调用 f(std::integral_constant<int, 线号>)，f 返回 true 时停止
+    template <Direction Dir, typename F>
+    static bool anyLine(F&& f) {
+        return [&]<int... Lines>(std::integer_sequence<int, Lines...>) {
+            return (f(std::integral_constant<int, Lines>{}) || ...);
+        }(std::make_integer_sequence<int, layout<Dir>().count>{});
+    }
+
+    // 行表里的方块不超过 2^14 时，连续合并的结果才不会超出 4 bit（合出 2^16 至少要有一个 2^14）
+    static constexpr int LARGE_EXPONENT =
+        Rule == movetable::MergeRule::CHAIN ? bitboard::MAX_EXPONENT - 1 : bitboard::MAX_EXPONENT;
+
+    // 按行表的格式打包一条线；有大方块（原版指数 >= 15，连续合并 >= 14）时返回 false
+    template <Direction Dir, int Line>
+    static bool gatherLine(const Board& board, movetable::Line& packed) {
+        constexpr const movetable::LineLayout& lines = layout<Dir>();
+        bool large = false;
+        packed = 0;
+        for (int i = 0; i < lines.lengths[Line]; ++i) {
+            const std::uint8_t exponent = board.cells[lines.cells[Line][i]];
+            large |= exponent >= LARGE_EXPONENT;
+            packed |= static_cast<movetable::Line>(exponent & 0xF) << (4 * i);
+        }
+        return !large;
+    }
+
+    template <Direction Dir, int Line>
+    static SlowSlide slideLine(const Board& board) {
+        constexpr const movetable::LineLayout& lines = layout<Dir>();
+        std::array<int, movetable::MAX_LENGTH> exponents{};
+        for (int i = 0; i < lines.lengths[Line]; ++i) {
+            exponents[i] = board.cells[lines.cells[Line][i]];
+        }
+        return slideSlow(exponents, lines.lengths[Line], Rule);
+    }
+
+    template <Direction Dir>
+    static bool moveLines(Board& board, Board::SlideTargets* targets) {
+        constexpr const movetable::LineLayout& lines = layout<Dir>();
+        const movetable::LineTable& table = movetable::table(Size, Rule);
+        bool moved = false;
+        int gained = 0;
+
+        anyLine<Dir>([&](auto lineConstant) {
+            constexpr int line = decltype(lineConstant)::value;
+            constexpr int length = lines.lengths[line];
+            constexpr const auto& lineCells = lines.cells[line];
+            std::array<int, movetable::MAX_LENGTH> lineTargets{};
+
+            movetable::Line packed;
+            if (gatherLine<Dir, line>(board, packed)) {
+                movetable::LineMove result = table.left(packed);
+                if (!result.moved) return false;
+
+                if (targets) {
+                    // 连续合并时合并掩码推不出去向，写回之前逐格重算一遍（只有 GUI 需要）
+                    if constexpr (Rule == movetable::MergeRule::CHAIN) {
+                        lineTargets = slideLine<Dir, line>(board).targets;
+                    } else {
+                        movetable::slideTargets(packed, result.mergeMask, length, lineTargets);
+                    }
+                }
+                for (int i = 0; i < length; ++i) {
+                    board.writeCell(lineCells[i], (result.line >> (4 * i)) & 0xF);
+                }
+                gained += result.score;
+            } else {
+                SlowSlide result = slideLine<Dir, line>(board);
+                if (!result.moved) return false;
+
+                for (int i = 0; i < length; ++i) {
+                    board.writeCell(lineCells[i], result.result[i]);
+                }
+                gained += result.score;
+                lineTargets = result.targets;
+            }
+
+            moved = true;
+            if (targets) {
+                for (int i = 0; i < length; ++i) {
+                    (*targets)[lineCells[i]] = lineCells[lineTargets[i]];
+                }
+            }
+            return false;
+        });
+
+        board.score += gained;
+        board.updateWon(gained);
+        return moved;
+    }
+
+    // 压缩棋盘能表示的局面：连续合并时同样要求没有指数 >= 14 的方块（nibble 的高三位不全为 1）
+    static bool fitsBitboard(Bitboard packed) {
+        if constexpr (Rule == movetable::MergeRule::CHAIN) {
+            return (packed & (packed >> 1) & (packed >> 2) & 0x2222222222222222ULL) == 0;
+        }
+        return true;
+    }
+
+    // 4x4 上下左右走压缩棋盘
+    static bool moveBitboard(Board& board, Bitboard packed, Direction dir, Board::SlideTargets* targets) {
+        constexpr bool chain = Rule == movetable::MergeRule::CHAIN;
+        bitboard::MoveResult result = chain ? bitboard::moveChain(packed, dir) : bitboard::move(packed, dir);
+        if (!result.moved) {
+            return false;
+        }
+        if (targets) {
+            std::array<std::uint8_t, 16> bitboardTargets;
+            if (chain) {
+                bitboard::slideTargetsChain(packed, dir, bitboardTargets);
+            } else {
+                bitboard::slideTargets(packed, dir, bitboardTargets);
+            }
+            std::copy(bitboardTargets.begin(), bitboardTargets.end(), targets->begin());
+        }
+        board.fromBitboard(result.board);
+        board.score += result.score;
+        board.updateWon(result.score);
+        return true;
+    }
+
+    static bool move(Board& board, Direction dir, Board::MoveTrace* trace) {
+        const std::uint64_t occupied = ~board.emptyMask & FULL_MASK;
+        Board::SlideTargets* targets = trace ? &trace->target : nullptr;
+        if (targets) {
+            for (int cell = 0; cell < CELLS; ++cell) {
+                (*targets)[cell] = static_cast<std::uint8_t>(cell);
+            }
+        }
+
+        bool moved;
+        Bitboard packed;
+        if (Size == 4 && !isDiagonal(dir) && board.toBitboard(packed) && fitsBitboard(packed)) {
+            moved = moveBitboard(board, packed, dir, targets);
+        } else {
+            switch (dir) {
+                case Direction::UP:         moved = moveLines<Direction::UP>(board, targets); break;
+                case Direction::DOWN:       moved = moveLines<Direction::DOWN>(board, targets); break;
+                case Direction::LEFT:       moved = moveLines<Direction::LEFT>(board, targets); break;
+                case Direction::RIGHT:      moved = moveLines<Direction::RIGHT>(board, targets); break;
+                case Direction::UP_LEFT:    moved = moveLines<Direction::UP_LEFT>(board, targets); break;
+                case Direction::UP_RIGHT:   moved = moveLines<Direction::UP_RIGHT>(board, targets); break;
+                case Direction::DOWN_LEFT:  moved = moveLines<Direction::DOWN_LEFT>(board, targets); break;
+                default:                    moved = moveLines<Direction::DOWN_RIGHT>(board, targets); break;
+            }
+        }
+
+        // 两个方块落到同一格即为合并
+        if (moved && trace) {
+            std::uint64_t landed = 0;
+            trace->mergedMask = 0;
+            for (std::uint64_t rest = occupied; rest != 0; rest &= rest - 1) {
+                const std::uint64_t bit = std::uint64_t(1) << trace->target[std::countr_zero(rest)];
+                trace->mergedMask |= landed & bit;
+                landed |= bit;
+            }
+        }
+        return moved;
+    }
+
+    template <Direction Dir>
+    static bool canMoveLines(const Board& board) {
+        const movetable::LineTable& table = movetable::table(Size, Rule);
+        return anyLine<Dir>([&](auto lineConstant) {
+            constexpr int line = decltype(lineConstant)::value;
+            movetable::Line packed;
+            if (gatherLine<Dir, line>(board, packed)) {
+                return table.left(packed).moved;
+            }
+            return slideLine<Dir, line>(board).moved;
+        });
+    }
+
+    static bool canMove(const Board& board, Direction dir) {
+        switch (dir) {
+            case Direction::UP:         return canMoveLines<Direction::UP>(board);
+            case Direction::DOWN:       return canMoveLines<Direction::DOWN>(board);
+            case Direction::LEFT:       return canMoveLines<Direction::LEFT>(board);
+            case Direction::RIGHT:      return canMoveLines<Direction::RIGHT>(board);
+            case Direction::UP_LEFT:    return canMoveLines<Direction::UP_LEFT>(board);
+            case Direction::UP_RIGHT:   return canMoveLines<Direction::UP_RIGHT>(board);
+            case Direction::DOWN_LEFT:  return canMoveLines<Direction::DOWN_LEFT>(board);
+            default:                    return canMoveLines<Direction::DOWN_RIGHT>(board);
+        }
+    }
+
+    // 查表：Dir 方向上有一条线向左或向右能移动时返回 true；遇到大方块时置 large 并停止
+    template <Direction Dir>
+    static bool anyLineCanMove(const Board& board, const movetable::LineTable& table, bool& large) {
+        return anyLine<Dir>([&](auto lineConstant) {
+            movetable::Line packed;
+            if (!gatherLine<Dir, decltype(lineConstant)::value>(board, packed)) {
+                large = true;
+                return true;
+            }
+            return table.canMove(packed);
+        });
+    }
+
+    static bool isGameOverGrid(const Board& board) {
+        // 有空格且有方块时总有一行或一列能移动；空棋盘与 4x4 位棋盘一致，不算结束
+        if (board.emptyMask != 0) {
+            return false;
+        }
+        Bitboard packed;
+        if (Size == 4 && board.toBitboard(packed)) {
+            return bitboard::isGameOver(packed);
+        }
+
+        const movetable::LineTable& table = movetable::table(Size, Rule);
+        bool large = false;
+        if (!anyLineCanMove<Direction::LEFT>(board, table, large)
+            && !anyLineCanMove<Direction::UP>(board, table, large)) {
+            return true;
+        }
+        if (!large) {
+            return false;
+        }
+        // 大方块退回逐方向检查
+        return !canMoveLines<Direction::LEFT>(board) && !canMoveLines<Direction::RIGHT>(board)
+            && !canMoveLines<Direction::UP>(board) && !canMoveLines<Direction::DOWN>(board);
+    }
+
+    // Dir 方向上某条线同时有空格和方块
+    template <Direction Dir>
+    static bool hasOpenLine(std::uint64_t emptyMask) {
+        return anyLine<Dir>([&](auto lineConstant) {
+            constexpr std::uint64_t lineMask = layout<Dir>().masks[decltype(lineConstant)::value];
+            return (emptyMask & lineMask) != 0 && (emptyMask & lineMask) != lineMask;
+        });
+    }
+
+    static bool isGameOverDiagonal(const Board& board) {
+        // 空棋盘上没有哪条斜线能移动，但与原版一致不算结束
+        if (board.emptyMask == board.fullMask()) {
+            return false;
+        }
+        // 某条斜线上同时有空格和方块时，沿这条线的两个方向之一一定能移动
+        if (hasOpenLine<Direction::UP_LEFT>(board.emptyMask) || hasOpenLine<Direction::UP_RIGHT>(board.emptyMask)) {
+            return false;
+        }
+
+        // 否则只剩合并的可能，四个斜向都无法改变棋盘才算结束
+        return !canMoveLines<Direction::UP_LEFT>(board) && !canMoveLines<Direction::UP_RIGHT>(board)
+            && !canMoveLines<Direction::DOWN_LEFT>(board) && !canMoveLines<Direction::DOWN_RIGHT>(board);
+    }
+
+    static constexpr Board::Kernels KERNELS = {&move, &canMove, &isGameOverGrid, &isGameOverDiagonal};
+};
+
+const std::array<Direction, 4>& versionDirections(GameVersion version) {
+    static const std::array<Direction, 4> gridDirections = {
+        Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT
+    };
+    static const std::array<Direction, 4> diagonalDirections = {
+        Direction::UP_LEFT, Direction::UP_RIGHT, Direction::DOWN_LEFT, Direction::DOWN_RIGHT
+    };
+    return version == GameVersion::MODIFIED ? diagonalDirections : gridDirections;
+}
+
+const Board::Kernels* Board::selectKernels(int size, GameVersion version) {
+    using movetable::MergeRule;
+    const bool chain = mergeRule(version) == MergeRule::CHAIN;
+    switch (size) {
+        case 4: return chain ? &SizedEngine<4, MergeRule::CHAIN>::KERNELS : &SizedEngine<4, MergeRule::STANDARD>::KERNELS;
+        case 5: return chain ? &SizedEngine<5, MergeRule::CHAIN>::KERNELS : &SizedEngine<5, MergeRule::STANDARD>::KERNELS;
+        case 6: return chain ? &SizedEngine<6, MergeRule::CHAIN>::KERNELS : &SizedEngine<6, MergeRule::STANDARD>::KERNELS;
+        default: throw std::invalid_argument("Unsupported grid size");
+    }
+}
+
+Board::Board(int size, GameVersion version) : size(size), version(version), kernels(selectKernels(size, version)) {
+    reset();
+}
+
+void Board::reset() {
+    cells.fill(0);
+    emptyMask = fullMask();
+    score = 0;
+    won = false;
+}
+
+int Board::getValue(int x, int y) const {
+    int exponent = getExponent(x, y);
+    return exponent == 0 ? 0 : (1 << exponent);
+}
+
+void Board::setValue(int x, int y, int value) {
+    writeCell(y * size + x, value == 0 ? 0 : std::countr_zero(static_cast<unsigned>(value)));
+}
+
+int Board::getMaxExponent() const {
+    int result = 0;
+    for (int cell = 0; cell < size * size; ++cell) {
+        result = std::max(result, static_cast<int>(cells[cell]));
+    }
+    return result;
+}
+
+int Board::addRandomTile(Rng& rng) {
+    const int emptyCount = getEmptyCount();
+    if (emptyCount == 0) {
+        return -1;
+    }
+
+    // 在空格掩码里取第 k 个为 1 的位
+    std::uint64_t mask = emptyMask;
+    for (std::uint32_t k = rng.nextBelow(static_cast<std::uint32_t>(emptyCount)); k > 0; --k) {
+        mask &= mask - 1;
+    }
+    const int cell = std::countr_zero(mask);
+    writeCell(cell, rng.nextBelow(10) < 8 ? 1 : 2);
+    return cell;
+}
+
+Board Board::transformed(int symmetry) const {
+    Board result = *this;
+    transformCells(symmetry, result.cells);
+    result.emptyMask = 0;
+    for (int cell = 0; cell < size * size; ++cell) {
+        if (result.cells[cell] == 0) result.emptyMask |= std::uint64_t(1) << cell;
+    }
+    return result;
+}
+
+void Board::transformCells(int symmetry, std::array<std::uint8_t, MAX_CELLS>& out) const {
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            auto [tx, ty] = symmetry::transformPoint(symmetry, x, y, size);
+            out[ty * size + tx] = cells[y * size + x];
+        }
+    }
+}
+
+int Board::canonicalSymmetry() const {
+    int symmetry = 0;
+    Bitboard packed;
+    if (size == 4 && toBitboard(packed)) {
+        bitboard::canonicalize(packed, symmetry);
+        return symmetry;
+    }
+
+    // 与压缩棋盘按数值比较的顺序相同：从最后一格往前比
+    std::array<std::uint8_t, MAX_CELLS> best;
+    std::array<std::uint8_t, MAX_CELLS> image;
+    transformCells(0, best);
+    for (int s = 1; s < symmetry::COUNT; ++s) {
+        transformCells(s, image);
+        for (int cell = size * size - 1; cell >= 0; --cell) {
+            if (image[cell] != best[cell]) {
+                if (image[cell] < best[cell]) {
+                    best = image;
+                    symmetry = s;
+                }
+                break;
+            }
+        }
+    }
+    return symmetry;
+}
+
+bool Board::toBitboard(Bitboard& board) const {
+    board = 0;
+    for (int cell = 0; cell < 16; ++cell) {
+        if (cells[cell] >= bitboard::MAX_EXPONENT) {
+            return false;
+        }
+        board |= static_cast<Bitboard>(cells[cell]) << (4 * cell);
+    }
+    return true;
+}
+
+void Board::fromBitboard(Bitboard board) {
+    for (int cell = 0; cell < 16; ++cell) {
+        cells[cell] = static_cast<std::uint8_t>((board >> (4 * cell)) & 0xF);
+    }
+    emptyMask = bitboard::emptyMask(board);
+}
+
+void Board::updateWon(int gained) {
+    // 合成 2048 的那次移动得分至少是 2048，其余情况不用扫描棋盘
+    if (!won && gained >= (1 << WIN_EXPONENT)) {
+        won = getMaxExponent() >= WIN_EXPONENT;
+    }
+}
+
+bool Board::move(Direction dir, MoveTrace* trace) {
+    return kernels->move(*this, dir, trace);
+}
+
+bool Board::canMove(Direction dir) const {
+    return kernels->canMove(*this, dir);
+}
+
+bool Board::isGameOver() const {
+    if (version == GameVersion::MODIFIED) {
+        return kernels->isGameOverDiagonal(*this);
+    } else {
+        return kernels->isGameOverGrid(*this);
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "Bitboard.h"
+#include "Direction.h"
+#include "MoveTables.h"
+#include "Rng.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// 原版；修改版只能斜向移动；连续合并版与原版走法相同，合并出的方块在同一步里还能继续合并
+enum class GameVersion {
+    ORIGINAL,
+    MODIFIED,
+    CONTINUOUS
+};
+
+inline movetable::MergeRule mergeRule(GameVersion version) {
+    return version == GameVersion::CONTINUOUS ? movetable::MergeRule::CHAIN : movetable::MergeRule::STANDARD;
+}
+
+// 某个版本可用的四个方向：原版和连续合并版为上下左右，修改版为四个斜向
+const std::array<Direction, 4>& versionDirections(GameVersion version);
+
+// 不依赖窗口的棋盘与规则：移动、生成新方块、判断结束，供 GUI 和无界面模拟共用
+class Board {
+public:
+    static constexpr int MAX_SIZE = movetable::MAX_LENGTH;
+    static constexpr int MAX_CELLS = MAX_SIZE * MAX_SIZE;
+    static constexpr int WIN_EXPONENT = 11; // 2048
+
+    using SlideTargets = std::array<std::uint8_t, MAX_CELLS>;
+
+    // 一次移动的逐格记录，按格子下标平铺，供动画直接使用
+    struct MoveTrace {
+        SlideTargets target;     // 移动前第 c 格的方块滑到的格子，空格和不动的方块为 c 本身
+        std::uint64_t mergedMask; // 第 c 位为 1 表示移动后第 c 格的方块由合并产生
+    };
+
+    explicit Board(int size = 4, GameVersion version = GameVersion::ORIGINAL);
+
+    void reset();
+
+    int getSize() const { return size; }
+    GameVersion getVersion() const { return version; }
+    int getScore() const { return score; }
+    bool hasWon() const { return won; }
+
+    // 格子上的指数（0 表示空格）与对应的数值
+    int getExponent(int x, int y) const { return cells[y * size + x]; }
+    int getValue(int x, int y) const;
+    void setValue(int x, int y, int value);
+    int getMaxExponent() const;
+
+    // 按行优先下标直接读写指数，供搜索等无界面代码使用
+    int getCellCount() const { return size * size; }
+    int getCell(int cell) const { return cells[cell]; }
+    void setCell(int cell, int exponent) { writeCell(cell, exponent); }
+
+    // 空格随移动增量维护：第 c 位为 1 表示格子 c 为空
+    std::uint64_t getEmptyMask() const { return emptyMask; }
+    int getEmptyCount() const { return std::popcount(emptyMask); }
+
+    const std::array<Direction, 4>& getDirections() const { return versionDirections(version); }
+
+    // 与 Game::moveTiles 相同的规则移动一次。trace 非空且移动成功时记录每个方块的去向和合并产生的格子
+    bool move(Direction dir, MoveTrace* trace = nullptr);
+    bool canMove(Direction dir) const;
+
+    // 在随机空格生成一个新方块（80% 为 2，20% 为 4），返回格子下标，没有空格时返回 -1
+    int addRandomTile(Rng& rng);
+
+    bool isGameOver() const;
+
+    // 4x4 棋盘压成 Bitboard；有方块 >= 32768 时返回 false，调用方改用格子数组
+    bool toBitboard(Bitboard& board) const;
+
+    // 按 Symmetry.h 编号的旋转/镜像变换后的棋盘，得分和胜负状态不变
+    Board transformed(int symmetry) const;
+    // 8 个对称像中作为等价类代表的那个的编号：同一类棋盘的 transformed(canonicalSymmetry()) 完全相同。
+    // 代表取按格子下标从大到小比较时最小的像，4x4 时与 bitboard::canonicalize 一致
+    int canonicalSymmetry() const;
+    // 把变换后的格子写入 out（行优先），不构造新棋盘
+    void transformCells(int symmetry, std::array<std::uint8_t, MAX_CELLS>& out) const;
+
+private:
+    template <int Size, movetable::MergeRule Rule> friend struct SizedEngine;
+
+    // 按边长和合并规则特化的规则实现（见 Board.cpp 的 SizedEngine），构造时按边长和版本选定一次
+    struct Kernels {
+        bool (*move)(Board& board, Direction dir, MoveTrace* trace);
+        bool (*canMove)(const Board& board, Direction dir);
+        bool (*isGameOverGrid)(const Board& board);
+        bool (*isGameOverDiagonal)(const Board& board);
+    };
+    static const Kernels* selectKernels(int size, GameVersion version);
+
+    int size;
+    GameVersion version;
+    const Kernels* kernels;
+    std::array<std::uint8_t, MAX_CELLS> cells; // 行优先存指数
+    std::uint64_t emptyMask;
+    int score;
+    bool won;
+
+    void writeCell(int cell, int exponent) {
+        cells[cell] = static_cast<std::uint8_t>(exponent);
+        const std::uint64_t bit = std::uint64_t(1) << cell;
+        emptyMask = exponent == 0 ? (emptyMask | bit) : (emptyMask & ~bit);
+    }
+
+    std::uint64_t fullMask() const {
+        return size * size == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << (size * size)) - 1;
+    }
+
+    void fromBitboard(Bitboard board);
+    void updateWon(int gained);
+};
+
+#endif // BOARD_H
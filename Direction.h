@@ -0,0 +1,50 @@
+#ifndef DIRECTION_H
+#define DIRECTION_H
+
+// 移动方向：原版只用上下左右，修改版只用四个斜向
+enum class Direction {
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT,
+    UP_LEFT,
+    UP_RIGHT,
+    DOWN_LEFT,
+    DOWN_RIGHT
+};
+
+constexpr int directionDx(Direction dir) {
+    switch (dir) {
+        case Direction::LEFT:
+        case Direction::UP_LEFT:
+        case Direction::DOWN_LEFT:  return -1;
+        case Direction::RIGHT:
+        case Direction::UP_RIGHT:
+        case Direction::DOWN_RIGHT: return 1;
+        default:                    return 0;
+    }
+}
+
+constexpr int directionDy(Direction dir) {
+    switch (dir) {
+        case Direction::UP:
+        case Direction::UP_LEFT:
+        case Direction::UP_RIGHT:   return -1;
+        case Direction::DOWN:
+        case Direction::DOWN_LEFT:
+        case Direction::DOWN_RIGHT: return 1;
+        default:                    return 0;
+    }
+}
+
+constexpr Direction directionFromDelta(int dx, int dy) {
+    if (dy < 0) return dx < 0 ? Direction::UP_LEFT : dx > 0 ? Direction::UP_RIGHT : Direction::UP;
+    if (dy > 0) return dx < 0 ? Direction::DOWN_LEFT : dx > 0 ? Direction::DOWN_RIGHT : Direction::DOWN;
+    return dx < 0 ? Direction::LEFT : Direction::RIGHT;
+}
+
+constexpr bool isDiagonal(Direction dir) {
+    return directionDx(dir) != 0 && directionDy(dir) != 0;
+}
+
+#endif // DIRECTION_H
@@ -0,0 +1,259 @@
+#include "Expectimax.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 估值权重（对数空间，参考常见 4x4 AI 的单行启发式）
+constexpr float LOST_PENALTY = 200000.0f;
+constexpr float MONOTONICITY_POWER = 4.0f;
+constexpr float MONOTONICITY_WEIGHT = 47.0f;
+constexpr float SUM_POWER = 3.5f;
+constexpr float SUM_WEIGHT = 11.0f;
+constexpr float MERGES_WEIGHT = 700.0f;
+constexpr float EMPTY_WEIGHT = 270.0f;
+
+constexpr int MAX_TRACKED_EXPONENT = 32;
+constexpr float SPAWN_TWO_PROBABILITY = 0.8f;
+
+struct PowerTables {
+    std::array<float, MAX_TRACKED_EXPONENT> monotonicity;
+    std::array<float, MAX_TRACKED_EXPONENT> sum;
+
+    PowerTables() {
+        for (int e = 0; e < MAX_TRACKED_EXPONENT; ++e) {
+            monotonicity[e] = std::pow(static_cast<float>(e), MONOTONICITY_POWER);
+            sum[e] = std::pow(static_cast<float>(e), SUM_POWER);
+        }
+    }
+};
+
+const PowerTables& powers() {
+    static const PowerTables instance;
+    return instance;
+}
+
+// 一条线的启发式：空格多、可合并的相邻方块多、单调、总量小更好
+float lineHeuristic(const std::array<int, movetable::MAX_LENGTH>& line, int length) {
+    const PowerTables& p = powers();
+    float sum = 0.0f;
+    int empty = 0;
+    int merges = 0;
+    int previous = 0;
+    int counter = 0;
+
+    for (int i = 0; i < length; ++i) {
+        int e = std::min(line[i], MAX_TRACKED_EXPONENT - 1);
+        sum += p.sum[e];
+        if (e == 0) {
+            ++empty;
+        } else {
+            if (previous == e) {
+                ++counter;
+            } else if (counter > 0) {
+                merges += 1 + counter;
+                counter = 0;
+            }
+            previous = e;
+        }
+    }
+    if (counter > 0) {
+        merges += 1 + counter;
+    }
+
+    float monotonicityLeft = 0.0f;
+    float monotonicityRight = 0.0f;
+    for (int i = 1; i < length; ++i) {
+        int a = std::min(line[i - 1], MAX_TRACKED_EXPONENT - 1);
+        int b = std::min(line[i], MAX_TRACKED_EXPONENT - 1);
+        if (a > b) {
+            monotonicityLeft += p.monotonicity[a] - p.monotonicity[b];
+        } else {
+            monotonicityRight += p.monotonicity[b] - p.monotonicity[a];
+        }
+    }
+
+    return LOST_PENALTY + EMPTY_WEIGHT * empty + MERGES_WEIGHT * merges
+        - MONOTONICITY_WEIGHT * std::min(monotonicityLeft, monotonicityRight)
+        - SUM_WEIGHT * sum;
+}
+
+// 对称的局面期望值相同（估值沿两组方向的线对称），按等价类代表取键，每类只占一项。
+// 每格取指数低 4 位拼成 64 位块再混合；指数 >= 16 的极少数局面可能冲突，只影响置换表命中
+std::uint64_t hashBoard(const Board& board) {
+    std::array<std::uint8_t, Board::MAX_CELLS> canonical;
+    board.transformCells(board.canonicalSymmetry(), canonical);
+
+    std::uint64_t hash = 0x9E3779B97F4A7C15ULL ^ static_cast<std::uint64_t>(board.getSize())
+        ^ (static_cast<std::uint64_t>(board.getVersion()) << 8);
+    std::uint64_t chunk = 0;
+    int shift = 0;
+    for (int cell = 0; cell < board.getCellCount(); ++cell) {
+        chunk |= static_cast<std::uint64_t>(canonical[cell] & 0xF) << shift;
+        shift += 4;
+        if (shift == 64 || cell + 1 == board.getCellCount()) {
+            hash ^= chunk;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33;
+            chunk = 0;
+            shift = 0;
+        }
+    }
+    return hash;
+}
+
+} // namespace
+
+ExpectimaxPlayer::ExpectimaxPlayer() : ExpectimaxPlayer(ExpectimaxOptions()) {}
+
+ExpectimaxPlayer::ExpectimaxPlayer(const ExpectimaxOptions& options)
+    : options(options),
+      table(std::size_t(1) << options.tableBits),
+      tableMask((std::uint64_t(1) << options.tableBits) - 1),
+      useDeadline(false),
+      aborted(false),
+      nodes(0),
+      lastDepth(0) {
+    clearTable();
+}
+
+void ExpectimaxPlayer::clearTable() {
+    std::fill(table.begin(), table.end(), TableEntry{0, 0.0f, 0});
+}
+
+bool ExpectimaxPlayer::chooseMove(const Board& board, Direction& best) {
+    nodes = 0;
+    aborted = false;
+    lastDepth = 0;
+    useDeadline = options.timeBudget.count() > 0;
+
+    if (!useDeadline) {
+        // 固定深度
+        if (searchRoot(board, options.maxDepth, best)) {
+            lastDepth = options.maxDepth;
+            return true;
+        }
+        return false;
+    }
+
+    // 迭代加深：只采用完整搜完的最深一层的结果，超时的那一层丢弃
+    deadline = std::chrono::steady_clock::now() + options.timeBudget;
+    bool found = false;
+    for (int depth = 1; depth <= options.maxDepth; ++depth) {
+        Direction candidate;
+        bool legal = searchRoot(board, depth, candidate);
+        if (aborted) break;
+        if (!legal) return false;
+
+        best = candidate;
+        found = true;
+        lastDepth = depth;
+        if (std::chrono::steady_clock::now() >= deadline) break;
+    }
+
+    // 连第一层都没搜完时退回任意合法方向
+    if (!found) {
+        for (Direction dir : board.getDirections()) {
+            if (board.canMove(dir)) {
+                best = dir;
+                return true;
+            }
+        }
+    }
+    return found;
+}
+
+bool ExpectimaxPlayer::searchRoot(const Board& board, int depth, Direction& best) {
+    float bestValue = -std::numeric_limits<float>::infinity();
+    bool found = false;
+
+    for (Direction dir : board.getDirections()) {
+        Board child = board;
+        if (!child.move(dir)) continue;
+
+        float value = searchChance(child, depth - 1, 1.0f);
+        if (aborted) return false;
+        if (!found || value > bestValue) {
+            bestValue = value;
+            best = dir;
+            found = true;
+        }
+    }
+    return found;
+}
+
+float ExpectimaxPlayer::searchMove(const Board& board, int depth, float probability) {
+    if ((++nodes & 255) == 0 && useDeadline && std::chrono::steady_clock::now() >= deadline) {
+        aborted = true;
+    }
+    if (aborted) {
+        return 0.0f;
+    }
+
+    float best = 0.0f; // 无路可走时视为输掉
+    for (Direction dir : board.getDirections()) {
+        Board child = board;
+        if (child.move(dir)) {
+            best = std::max(best, searchChance(child, depth - 1, probability));
+        }
+    }
+    return best;
+}
+
+float ExpectimaxPlayer::searchChance(const Board& board, int depth, float probability) {
+    if (depth <= 0 || probability < options.probabilityThreshold) {
+        return evaluate(board);
+    }
+
+    const std::uint64_t key = hashBoard(board);
+    TableEntry& entry = table[key & tableMask];
+    if (entry.depth >= depth && entry.key == key) {
+        return entry.value;
+    }
+
+    const int emptyCount = board.getEmptyCount();
+    if (emptyCount == 0) {
+        return evaluate(board);
+    }
+
+    const float twoProbability = probability * SPAWN_TWO_PROBABILITY / emptyCount;
+    const float fourProbability = probability * (1.0f - SPAWN_TWO_PROBABILITY) / emptyCount;
+    float total = 0.0f;
+    for (std::uint64_t empty = board.getEmptyMask(); empty != 0; empty &= empty - 1) {
+        const int cell = std::countr_zero(empty);
+        Board child = board;
+        child.setCell(cell, 1);
+        total += SPAWN_TWO_PROBABILITY * searchMove(child, depth, twoProbability);
+        child.setCell(cell, 2);
+        total += (1.0f - SPAWN_TWO_PROBABILITY) * searchMove(child, depth, fourProbability);
+        if (aborted) return 0.0f;
+    }
+
+    float value = total / emptyCount;
+    entry = TableEntry{key, value, static_cast<std::uint8_t>(depth)};
+    return value;
+}
+
+float ExpectimaxPlayer::evaluate(const Board& board) const {
+    // 沿本版本能滑动的两个方向取线：原版和连续合并版为行和列，修改版为两组对角线
+    const bool diagonal = board.getVersion() == GameVersion::MODIFIED;
+    const Direction axes[2] = {
+        diagonal ? Direction::UP_LEFT : Direction::LEFT,
+        diagonal ? Direction::UP_RIGHT : Direction::UP
+    };
+
+    float total = 0.0f;
+    std::array<int, movetable::MAX_LENGTH> line;
+    for (Direction axis : axes) {
+        const movetable::LineLayout& layout = movetable::layout(board.getSize(), axis);
+        for (int l = 0; l < layout.count; ++l) {
+            for (int i = 0; i < layout.lengths[l]; ++i) {
+                line[i] = board.getCell(layout.cells[l][i]);
+            }
+            total += lineHeuristic(line, layout.lengths[l]);
+        }
+    }
+    return total;
+}
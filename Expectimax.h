@@ -0,0 +1,53 @@
+#ifndef EXPECTIMAX_H
+#define EXPECTIMAX_H
+
+#include "Board.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+struct ExpectimaxOptions {
+    int maxDepth = 3;                         // 最大搜索层数（一次移动加一次生成算一层）
+    double probabilityThreshold = 1e-4;       // 到达概率低于该值的期望节点直接估值
+    std::chrono::microseconds timeBudget{0};  // 大于 0 时按时间迭代加深，maxDepth 作为上限
+    int tableBits = 20;                       // 置换表共 2^tableBits 项
+};
+
+// 期望最大化搜索的自动玩家：最大节点选方向，期望节点按 addRandomTile 的分布（80% 为 2，20% 为 4）
+// 对所有空格取平均。原版和修改版共用，估值沿各自的移动方向取线
+class ExpectimaxPlayer {
+public:
+    ExpectimaxPlayer();
+    explicit ExpectimaxPlayer(const ExpectimaxOptions& options);
+
+    // 为当前棋盘选择方向；没有可走的方向时返回 false
+    bool chooseMove(const Board& board, Direction& best);
+    void clearTable();
+
+    int getLastDepth() const { return lastDepth; }
+    std::uint64_t getLastNodes() const { return nodes; }
+
+private:
+    struct TableEntry {
+        std::uint64_t key;
+        float value;
+        std::uint8_t depth; // 0 表示空项
+    };
+
+    ExpectimaxOptions options;
+    std::vector<TableEntry> table;
+    std::uint64_t tableMask;
+
+    std::chrono::steady_clock::time_point deadline;
+    bool useDeadline;
+    bool aborted;
+    std::uint64_t nodes;
+    int lastDepth;
+
+    bool searchRoot(const Board& board, int depth, Direction& best);
+    float searchMove(const Board& board, int depth, float probability);
+    float searchChance(const Board& board, int depth, float probability);
+    float evaluate(const Board& board) const;
+};
+
+#endif // EXPECTIMAX_H
@@ -0,0 +1,160 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+double toMilliseconds(std::int64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+// 已排序数组的分位数（最近秩）
+double percentile(const std::vector<double>& sorted, std::size_t count, double fraction) {
+    const std::size_t rank = static_cast<std::size_t>(fraction * static_cast<double>(count - 1) + 0.5);
+    return sorted[std::min(rank, count - 1)];
+}
+
+} // namespace
+
+FrameProfiler::FrameProfiler(std::size_t frameCapacity)
+    : frames(std::max<std::size_t>(frameCapacity, 1)), next(0), count(0), inFrame(false), allocationCounter(nullptr),
+      epoch(std::chrono::steady_clock::now()), scratch(frames.size()) {}
+
+std::int64_t FrameProfiler::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void FrameProfiler::beginFrame() {
+    Frame& frame = current();
+    frame.start = now();
+    frame.duration = 0;
+    frame.drawCalls = 0;
+    frame.allocations = allocationCounter ? allocationCounter() : 0;
+    frame.eventCount = 0;
+    inFrame = true;
+}
+
+void FrameProfiler::endFrame() {
+    if (!inFrame) return;
+    Frame& frame = current();
+    frame.duration = now() - frame.start;
+    frame.allocations = allocationCounter ? allocationCounter() - frame.allocations : 0;
+    inFrame = false;
+    next = (next + 1) % frames.size();
+    count = std::min(count + 1, frames.size());
+}
+
+void FrameProfiler::addDrawCalls(int calls) {
+    if (inFrame) {
+        current().drawCalls += calls;
+    }
+}
+
+FrameProfiler::Scope::Scope(FrameProfiler& profiler, const char* name) : profiler(profiler), index(-1) {
+    if (!profiler.inFrame) return;
+    Frame& frame = profiler.current();
+    if (frame.eventCount >= MAX_EVENTS) return;
+    index = frame.eventCount++;
+    frame.events[index] = {name, profiler.now(), 0};
+}
+
+FrameProfiler::Scope::~Scope() {
+    if (index < 0 || !profiler.inFrame) return;
+    Event& event = profiler.current().events[index];
+    event.duration = profiler.now() - event.start;
+}
+
+const FrameProfiler::Frame& FrameProfiler::frameAt(std::size_t age) const {
+    return frames[(next + frames.size() - count + age) % frames.size()];
+}
+
+FrameProfiler::Summary FrameProfiler::summarize() {
+    Summary summary;
+    summary.frames = count;
+    if (count == 0) {
+        return summary;
+    }
+
+    std::int64_t total = 0;
+    std::int64_t drawCalls = 0;
+    std::uint64_t allocations = 0;
+    std::array<std::int64_t, MAX_PHASES> phaseTotals{};
+    for (std::size_t age = 0; age < count; ++age) {
+        const Frame& frame = frameAt(age);
+        scratch[age] = toMilliseconds(frame.duration);
+        total += frame.duration;
+        drawCalls += frame.drawCalls;
+        allocations += frame.allocations;
+        summary.maxAllocations = std::max(summary.maxAllocations, frame.allocations);
+
+        // 同一帧内同名阶段先累加，再更新平均和最大值
+        std::array<std::int64_t, MAX_PHASES> frameTotals{};
+        for (int e = 0; e < frame.eventCount; ++e) {
+            const Event& event = frame.events[e];
+            int phase = 0;
+            while (phase < summary.phaseCount && summary.phases[phase].name != event.name) ++phase;
+            if (phase == summary.phaseCount) {
+                if (phase == MAX_PHASES) continue;
+                summary.phases[summary.phaseCount++] = {event.name, 0.0, 0.0};
+            }
+            frameTotals[phase] += event.duration;
+        }
+        for (int phase = 0; phase < summary.phaseCount; ++phase) {
+            phaseTotals[phase] += frameTotals[phase];
+            summary.phases[phase].maxMs = std::max(summary.phases[phase].maxMs, toMilliseconds(frameTotals[phase]));
+        }
+    }
+
+    std::sort(scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(count));
+    summary.averageMs = toMilliseconds(total) / static_cast<double>(count);
+    summary.p50Ms = percentile(scratch, count, 0.50);
+    summary.p95Ms = percentile(scratch, count, 0.95);
+    summary.p99Ms = percentile(scratch, count, 0.99);
+    summary.maxMs = scratch[count - 1];
+    summary.drawCalls = static_cast<double>(drawCalls) / static_cast<double>(count);
+    summary.countsAllocations = allocationCounter != nullptr;
+    summary.allocations = static_cast<double>(allocations) / static_cast<double>(count);
+    for (int phase = 0; phase < summary.phaseCount; ++phase) {
+        summary.phases[phase].averageMs = toMilliseconds(phaseTotals[phase]) / static_cast<double>(count);
+    }
+
+    // 帧率按第一帧开始到最后一帧结束的墙钟时间计算，包含帧之间的等待
+    const Frame& first = frameAt(0);
+    const Frame& last = frameAt(count - 1);
+    const std::int64_t span = last.start + last.duration - first.start;
+    summary.fps = span > 0 ? static_cast<double>(count) * 1e9 / static_cast<double>(span) : 0.0;
+    return summary;
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string& path) const {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    // 完整事件（ph = X），时间单位为微秒；每帧本身也是一个事件，各阶段按时间嵌套在其中
+    std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+    auto writeEvent = [&](const char* name, std::int64_t start, std::int64_t duration, const Frame* frame) {
+        std::fprintf(file, "%s  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %.3f, \"dur\": %.3f",
+                     first ? "" : ",\n", name, start / 1e3, duration / 1e3);
+        if (frame) {
+            std::fprintf(file, ", \"args\": {\"drawCalls\": %d", frame->drawCalls);
+            if (allocationCounter) {
+                std::fprintf(file, ", \"allocations\": %llu", static_cast<unsigned long long>(frame->allocations));
+            }
+            std::fprintf(file, "}");
+        }
+        std::fprintf(file, "}");
+        first = false;
+    };
+    for (std::size_t age = 0; age < count; ++age) {
+        const Frame& frame = frameAt(age);
+        writeEvent("frame", frame.start, frame.duration, &frame);
+        for (int e = 0; e < frame.eventCount; ++e) {
+            writeEvent(frame.events[e].name, frame.events[e].start, frame.events[e].duration, nullptr);
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
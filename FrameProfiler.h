@@ -0,0 +1,97 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 逐帧计时：主循环每帧调用 beginFrame/endFrame，其间用 Scope 标出各阶段。
+// 最近 frameCapacity 帧放在预先分配好的环形缓冲里，记录时不分配内存；
+// 可以汇总成帧率和帧时间分位数，也可以导出为 Chrome 的 trace event JSON（chrome://tracing、Perfetto 可直接打开）
+class FrameProfiler {
+public:
+    static constexpr int MAX_EVENTS = 32; // 每帧最多记录的计时区间，多出的丢弃
+    static constexpr int MAX_PHASES = 16; // 汇总时区分的阶段名个数
+
+    explicit FrameProfiler(std::size_t frameCapacity = 600);
+
+    void beginFrame();
+    void endFrame();
+    void addDrawCalls(int count = 1);
+    // 设置后每帧还记录 counter 在帧内的增量，用来检查稳定运行时是否分配内存；
+    // 计数函数由 AllocationCounter 提供，只在开启分配统计的构建里设置
+    void setAllocationCounter(std::uint64_t (*counter)()) { allocationCounter = counter; }
+
+    // 构造时开始、析构时结束一个计时区间，可以嵌套；name 须为字符串常量，按指针区分阶段
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler& profiler;
+        int index; // 本帧事件下标，-1 表示没有记录
+    };
+
+    struct PhaseStats {
+        const char* name;
+        double averageMs; // 按帧平均（一帧内多次出现时累加）
+        double maxMs;
+    };
+
+    struct Summary {
+        std::size_t frames = 0;
+        double fps = 0.0;
+        double averageMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        double drawCalls = 0.0; // 每帧平均
+        bool countsAllocations = false;
+        double allocations = 0.0; // 每帧平均，countsAllocations 为真时有效
+        std::uint64_t maxAllocations = 0;
+        std::array<PhaseStats, MAX_PHASES> phases{};
+        int phaseCount = 0;
+    };
+
+    // 汇总缓冲中的所有帧
+    Summary summarize();
+    // 按时间顺序写出缓冲中的帧，失败时返回 false
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    struct Event {
+        const char* name;
+        std::int64_t start;    // 相对 epoch 的纳秒
+        std::int64_t duration;
+    };
+
+    struct Frame {
+        std::int64_t start;
+        std::int64_t duration;
+        int drawCalls;
+        std::uint64_t allocations; // 进行中时为帧开始时的计数，结束后为增量
+        int eventCount;
+        std::array<Event, MAX_EVENTS> events;
+    };
+
+    std::vector<Frame> frames; // 环形缓冲
+    std::size_t next;          // 下一帧写入的位置
+    std::size_t count;         // 已记录的帧数，不超过容量
+    bool inFrame;
+    std::uint64_t (*allocationCounter)();
+    std::chrono::steady_clock::time_point epoch;
+    std::vector<double> scratch; // 求分位数用，构造时按容量分配
+
+    std::int64_t now() const;
+    Frame& current() { return frames[next]; }
+    const Frame& frameAt(std::size_t age) const; // 0 为最早的一帧
+};
+
+#endif // FRAMEPROFILER_H
@@ -1,7 +1,12 @@
 #include "Game2048.h"
+#include <bit>
+#include <cmath>
+#include <cstdio>
 #include <stdexcept>
-#include <random>
-#include <sstream>
+
+#ifdef MY2048_COUNT_ALLOCATIONS
+#include "AllocationCounter.h"
+#endif
 
 // 窗口的宽度
 constexpr int WINDOW_WIDTH = 800;
@@ -20,28 +25,248 @@ constexpr int GRID_LINE_THICKNESS = 4; // 增加网格线粗细，让网格更
 // 网格线的颜色
 const sf::Color GRID_LINE_COLOR = sf::Color(119, 110, 101);
 
-Game::Game() : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "2048 Game"),
+// 逻辑更新的固定步长（秒），与实际帧率无关
+constexpr float FIXED_TIMESTEP = 1.0f / 120.0f;
+// 单帧最多补算的时间，避免窗口被拖动或卡顿后一次补算过多步
+constexpr float MAX_FRAME_TIME = 0.25f;
+
+// 合并方块弹跳的持续时间（秒）
+constexpr float MERGE_ANIMATION_DURATION = 0.15f;
+
+// 图集默认预先渲染到 2^17 = 131072，更大的数出现时再扩充
+constexpr int DEFAULT_LABEL_EXPONENT = 17;
+// 数字字号，过长的数字按方块宽度缩小
+constexpr unsigned LABEL_CHARACTER_SIZE = 32;
+
+// 把 ASCII 文本原地写进 out：逐字符追加，out 的容量够用后不再分配内存
+// （用 const char* 直接构造 sf::String 每次都会申请新的缓冲区）
+void assignAscii(sf::String& out, const char* text) {
+    out.clear();
+    for (; *text; ++text) {
+        out += sf::String(static_cast<sf::Uint32>(*text));
+    }
+}
+
+// 往顶点数组里追加一个带纹理坐标的矩形（两个三角形）
+void appendRect(sf::VertexArray& vertices, const sf::FloatRect& rect, const sf::FloatRect& texRect, sf::Color color) {
+    const float right = rect.left + rect.width;
+    const float bottom = rect.top + rect.height;
+    const float texRight = texRect.left + texRect.width;
+    const float texBottom = texRect.top + texRect.height;
+    const sf::Vertex topLeft(sf::Vector2f(rect.left, rect.top), color, sf::Vector2f(texRect.left, texRect.top));
+    const sf::Vertex topRight(sf::Vector2f(right, rect.top), color, sf::Vector2f(texRight, texRect.top));
+    const sf::Vertex bottomRight(sf::Vector2f(right, bottom), color, sf::Vector2f(texRight, texBottom));
+    const sf::Vertex bottomLeft(sf::Vector2f(rect.left, bottom), color, sf::Vector2f(texRect.left, texBottom));
+    vertices.append(topLeft);
+    vertices.append(topRight);
+    vertices.append(bottomRight);
+    vertices.append(topLeft);
+    vertices.append(bottomRight);
+    vertices.append(bottomLeft);
+}
+
+// 自动玩家每步最多思考 5 毫秒
+ExpectimaxOptions autoPlayOptions() {
+    ExpectimaxOptions options;
+    options.maxDepth = 6;
+    options.timeBudget = std::chrono::milliseconds(5);
+    return options;
+}
+
+// 修改版的自动玩家：rollout 在固定步长的 update 里同步进行，与期望最大化一样每步最多 5 毫秒，
+// 只用两个线程，自动玩家开着时也不会占满共享机器的全部核心
+MonteCarloOptions rolloutPlayOptions(std::uint64_t seed) {
+    MonteCarloOptions options;
+    options.rolloutsPerMove = 2000;
+    options.timeBudget = std::chrono::milliseconds(5);
+    options.threads = 2;
+    options.policy = RolloutPolicy::GREEDY;
+    options.seed = seed;
+    return options;
+}
+
+Game::Game(std::uint64_t seed, const DisplayOptions& display, record::RecordWriter* recorder,
+           const NTupleNetwork* network) : window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "2048 Game"),
                currentState(GameState::MAIN_MENU),
                currentVersion(GameVersion::ORIGINAL),
                gridSize(4),
+               cellAnimations{},
+               sliding(false),
+               animationProgress(0.0f),
+               animationDuration(1.0f), // 将动画持续时间从 0.5 秒增加到 1.0 秒
+               mergeProgress(1.0f),
+               profiler(display.traceFrames),
+               showProfiler(false),
+               profilerRefresh(0.0f),
+               tracePath(display.tracePath),
+               needsRedraw(true),
+               boardVertices(sf::Triangles),
+               boardVerticesDirty(true),
+               labelAtlasColumns(1),
+               labelAtlasMaxExponent(0),
+               gameStarted(false),
                score(0),
                gameOver(false),
                gameWon(false),
-               animationProgress(0.0f),
-               animationDuration(1.0f) { // 将动画持续时间从 0.5 秒增加到 1.0 秒
+               autoPlayer(autoPlayOptions()),
+               rolloutPlayer(rolloutPlayOptions(seed)),
+               network(network),
+               autoPlay(false),
+               seedSource(seed),
+               gameSeed(0),
+               recorder(recorder),
+               recordOpen(false),
+               displayedScore(-1) {
     if (!font.loadFromFile("../arial.ttf")) {
         throw std::runtime_error("Failed to load font");
     }
+
+    // 开启垂直同步时不再叠加帧率上限，两者同时使用会互相干扰
+    if (display.verticalSync) {
+        window.setVerticalSyncEnabled(true);
+    } else {
+        window.setFramerateLimit(display.frameLimit);
+    }
     
     setupTileColors();
+#ifdef MY2048_COUNT_ALLOCATIONS
+    profiler.setAllocationCounter(allocation::count);
+#endif
     initializeUI();
     setupExitConfirmUI();
+
+    // 性能分析叠加层：左上角半透明底板加等宽排列的文字
+    profilerBackground.setPosition(8, 8);
+    profilerBackground.setFillColor(sf::Color(0, 0, 0, 170));
+    profilerText.setFont(font);
+    profilerText.setCharacterSize(14);
+    profilerText.setFillColor(sf::Color::White);
+    profilerText.setPosition(16, 12);
+
+    // 按菜单上的尺寸从小到大生成，先选小棋盘时等待最短
+    tableWarmup = std::thread([] {
+        for (int size = movetable::MIN_LENGTH; size <= movetable::MAX_LENGTH; ++size) {
+            movetable::table(size, movetable::MergeRule::STANDARD);
+            movetable::table(size, movetable::MergeRule::CHAIN);
+        }
+    });
+}
+
+Game::~Game() {
+    // 行表是函数内静态对象，退出前要等后台生成结束
+    if (tableWarmup.joinable()) {
+        tableWarmup.join();
+    }
 }
 
 void Game::run() {
+    sf::Clock clock;
+    float accumulator = 0.0f;
     while (window.isOpen()) {
-        processEvents();
-        update();
+        // 画面静止时阻塞等待下一个事件，空闲的窗口不占用 CPU 和 GPU
+        if (!needsRedraw && !isAnimating()) {
+            sf::Event event;
+            if (window.waitEvent(event)) {
+                handleEvent(event);
+            }
+            // 等待的时间不计入动画
+            clock.restart();
+            accumulator = 0.0f;
+        }
+
+        profiler.beginFrame();
+        {
+            FrameProfiler::Scope scope(profiler, "processEvents");
+            processEvents();
+        }
+
+        // 按真实经过的时间推进若干个固定步长，动画速度不受帧率影响
+        accumulator += std::min(clock.restart().asSeconds(), MAX_FRAME_TIME);
+        {
+            FrameProfiler::Scope scope(profiler, "update");
+            while (accumulator >= FIXED_TIMESTEP) {
+                update(FIXED_TIMESTEP);
+                accumulator -= FIXED_TIMESTEP;
+            }
+        }
+
+        // 动画期间每帧都画，由帧率上限或垂直同步控制节奏
+        if (needsRedraw || isAnimating()) {
+            render();
+            needsRedraw = false;
+        }
+        profiler.endFrame();
+    }
+
+    // 关闭窗口时写出未结束的一局
+    finishRecord();
+    if (!tracePath.empty()) {
+        writeTrace();
+    }
+}
+
+void Game::draw(const sf::Drawable& drawable, const sf::RenderStates& states) {
+    window.draw(drawable, states);
+    profiler.addDrawCalls();
+}
+
+void Game::writeTrace() {
+    const std::string path = tracePath.empty() ? "frame_trace.json" : tracePath;
+    if (!profiler.writeChromeTrace(path)) {
+        std::fprintf(stderr, "Failed to write frame trace: %s\n", path.c_str());
+    }
+}
+
+void Game::updateProfilerText() {
+    const FrameProfiler::Summary summary = profiler.summarize();
+    char buffer[1024];
+    int length = std::snprintf(buffer, sizeof(buffer),
+                               "FPS %.1f  frames %zu\nframe ms  avg %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f\n"
+                               "draw calls %.1f\n",
+                               summary.fps, summary.frames, summary.averageMs, summary.p50Ms, summary.p95Ms,
+                               summary.p99Ms, summary.maxMs, summary.drawCalls);
+    if (summary.countsAllocations) {
+        length += std::snprintf(buffer + length, sizeof(buffer) - length, "allocations %.2f/frame  max %llu\n",
+                                summary.allocations, static_cast<unsigned long long>(summary.maxAllocations));
+    }
+    for (int i = 0; i < summary.phaseCount && length < static_cast<int>(sizeof(buffer)); ++i) {
+        const FrameProfiler::PhaseStats& phase = summary.phases[i];
+        length += std::snprintf(buffer + length, sizeof(buffer) - length, "%-14s avg %.3f  max %.3f ms\n",
+                                phase.name, phase.averageMs, phase.maxMs);
+    }
+    assignAscii(profilerString, buffer);
+    profilerText.setString(profilerString);
+    const sf::FloatRect bounds = profilerText.getLocalBounds();
+    profilerBackground.setSize(sf::Vector2f(bounds.left + bounds.width + 16, bounds.top + bounds.height + 12));
+}
+
+void Game::loadPosition(const Board& position) {
+    if (currentState != GameState::GAME || gridSize != position.getSize() || currentVersion != position.getVersion()) {
+        initializeGame(position.getSize(), position.getVersion());
+        currentState = GameState::GAME;
+    }
+    board = position;
+    syncBoard();
+    gameOver = board.isGameOver();
+    updateGameOverText();
+    sliding = false;
+    cellAnimations.mergedMask = 0;
+    cellAnimations.spawnMask = 0;
+}
+
+bool Game::playInput(const Board& position, Direction dir) {
+    loadPosition(position);
+    const bool moved = playMove(dir);
+    update(FIXED_TIMESTEP);
+    return moved;
+}
+
+void Game::renderFrames(const Board& position, int frames, bool rebuild) {
+    loadPosition(position);
+    for (int i = 0; i < frames; ++i) {
+        if (rebuild) {
+            boardVerticesDirty = true;
+        }
         render();
     }
 }
@@ -112,6 +337,10 @@ void Game::initializeUI() {
     scoreText.setFillColor(sf::Color::White);
     scoreText.setPosition(20, 20);
     
+    // 游戏结束时盖在棋盘上的半透明遮罩
+    gameOverOverlay.setSize(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+    gameOverOverlay.setFillColor(sf::Color(0, 0, 0, 150));
+
     // 游戏结束显示文本
     gameOverText.setFont(font);
     gameOverText.setString("Game Over!");
@@ -168,9 +397,10 @@ void Game::setupVersionMenu() {
     versionTitleText.setFillColor(sf::Color::White);
     versionTitleText.setPosition(280, 100);
     
-    const std::array<std::string, 2> versionLabels = {
+    const std::array<std::string, 3> versionLabels = {
         "Original Version (Arrow Keys)",
-        "Diagonal Only (Q/E/Z/C Keys)"
+        "Diagonal Only (Q/E/Z/C Keys)",
+        "Chain Merges (Arrow Keys)"
     };
     
     for (size_t i = 0; i < versionButtons.size(); ++i) {
@@ -194,63 +424,87 @@ void Game::setupVersionMenu() {
 void Game::processEvents() {
     sf::Event event;
     while (window.pollEvent(event)) {
-        // 关闭窗口事件
-        if (event.type == sf::Event::Closed) {
+        handleEvent(event);
+    }
+}
+
+bool Game::isAnimating() const {
+    // 自动游玩时每一帧都可能走下一步，也算作动画
+    // 打开性能分析叠加层时持续出帧，数字才有意义
+    return sliding || cellAnimations.mergedMask != 0 || cellAnimations.spawnMask != 0
+        || (autoPlay && currentState == GameState::GAME && !gameOver) || showProfiler;
+}
+
+void Game::handleEvent(const sf::Event& event) {
+    // 除鼠标移动外的事件都可能改变画面（包括窗口重新获得焦点、尺寸变化）
+    if (event.type != sf::Event::MouseMoved) {
+        needsRedraw = true;
+    }
+
+    // 关闭窗口事件
+    if (event.type == sf::Event::Closed) {
+        currentState = GameState::EXIT_CONFIRM;
+    }
+
+    // 键盘输入事件
+    if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::Escape) {
             currentState = GameState::EXIT_CONFIRM;
+        } else if (event.key.code == sf::Keyboard::F3) {
+            showProfiler = !showProfiler;
+            profilerRefresh = 0.0f;
+            if (showProfiler) updateProfilerText();
+        } else if (event.key.code == sf::Keyboard::F4) {
+            writeTrace();
         }
 
-        // 键盘输入事件
-        if (event.type == sf::Event::KeyPressed) {
-            if (event.key.code == sf::Keyboard::Escape) {
-                currentState = GameState::EXIT_CONFIRM;
-            }
-
-            // 退出确认界面处理
-            if (currentState == GameState::EXIT_CONFIRM) {
-                if (event.key.code == sf::Keyboard::Y) {
-                    window.close();
-                } else if (event.key.code == sf::Keyboard::N) {
-                    if (grid.empty()) {
-                        currentState = GameState::MAIN_MENU;
-                    } else {
-                        currentState = GameState::GAME;
-                    }
+        // 退出确认界面处理
+        if (currentState == GameState::EXIT_CONFIRM) {
+            if (event.key.code == sf::Keyboard::Y) {
+                window.close();
+            } else if (event.key.code == sf::Keyboard::N) {
+                if (!gameStarted) {
+                    currentState = GameState::MAIN_MENU;
+                } else {
+                    currentState = GameState::GAME;
                 }
             }
+        }
 
-            // 方向键 和 R 键逻辑：只在游戏中触发
-            if (currentState == GameState::GAME) {
-                if (event.key.code == sf::Keyboard::R) {
-                    resetGame();
-                } else if (!gameOver) {
-                    handleGameInput(event.key.code);  // 支持方向键
-                }
+        // 方向键 和 R 键逻辑：只在游戏中触发
+        if (currentState == GameState::GAME) {
+            if (event.key.code == sf::Keyboard::R) {
+                resetGame();
+            } else if (event.key.code == sf::Keyboard::A) {
+                autoPlay = !autoPlay;
+            } else if (!gameOver) {
+                handleGameInput(event.key.code);  // 支持方向键
             }
         }
+    }
+
+    // 鼠标点击事件
+    if (event.type == sf::Event::MouseButtonPressed) {
+        sf::Vector2f mousePos(event.mouseButton.x, event.mouseButton.y);
 
-        // 鼠标点击事件
-        if (event.type == sf::Event::MouseButtonPressed) {
-            sf::Vector2f mousePos(event.mouseButton.x, event.mouseButton.y);
-
-            if (currentState == GameState::EXIT_CONFIRM) {
-                if (exitConfirmYesButton.getGlobalBounds().contains(mousePos)) {
-                    window.close();
-                } else if (exitConfirmNoButton.getGlobalBounds().contains(mousePos)) {
-                    if (grid.empty()) {
-                        currentState = GameState::MAIN_MENU;
-                    } else {
-                        currentState = GameState::GAME;
-                    }
+        if (currentState == GameState::EXIT_CONFIRM) {
+            if (exitConfirmYesButton.getGlobalBounds().contains(mousePos)) {
+                window.close();
+            } else if (exitConfirmNoButton.getGlobalBounds().contains(mousePos)) {
+                if (!gameStarted) {
+                    currentState = GameState::MAIN_MENU;
+                } else {
+                    currentState = GameState::GAME;
                 }
-                continue;
             }
+            return;
+        }
 
-            // 菜单点击逻辑
-            if (currentState == GameState::MAIN_MENU) {
-                handleMainMenuClick(mousePos);
-            } else if (currentState == GameState::VERSION_MENU) {
-                handleVersionMenuClick(mousePos);
-            }
+        // 菜单点击逻辑
+        if (currentState == GameState::MAIN_MENU) {
+            handleMainMenuClick(mousePos);
+        } else if (currentState == GameState::VERSION_MENU) {
+            handleVersionMenuClick(mousePos);
         }
     }
 }
@@ -277,49 +531,77 @@ void Game::handleVersionMenuClick(const sf::Vector2f& pos) {
 }
 
 void Game::handleGameInput(sf::Keyboard::Key key) {
-    bool moved = false;
-    
-    if (currentVersion == GameVersion::ORIGINAL) {
-        // 原始版本：只支持上下左右
+    Direction dir;
+    if (currentVersion != GameVersion::MODIFIED) {
+        // 原始版本和连续合并版本：只支持上下左右
         switch (key) {
-            case sf::Keyboard::Up:    moved = moveTiles(0, -1); break;
-            case sf::Keyboard::Down:  moved = moveTiles(0, 1);  break;
-            case sf::Keyboard::Left:  moved = moveTiles(-1, 0); break;
-            case sf::Keyboard::Right: moved = moveTiles(1, 0);  break;
-            default: break;
+            case sf::Keyboard::Up:    dir = Direction::UP; break;
+            case sf::Keyboard::Down:  dir = Direction::DOWN; break;
+            case sf::Keyboard::Left:  dir = Direction::LEFT; break;
+            case sf::Keyboard::Right: dir = Direction::RIGHT; break;
+            default: return;
         }
     } else {
         // 修改版本：仅支持斜向移动
         switch (key) {
-            case sf::Keyboard::Q:     moved = moveTiles(-1, -1); break; // 左上
-            case sf::Keyboard::E:     moved = moveTiles(1, -1); break;  // 右上
-            case sf::Keyboard::Z:     moved = moveTiles(-1, 1); break;  // 左下
-            case sf::Keyboard::C:     moved = moveTiles(1, 1); break;   // 右下
-            default: break;
+            case sf::Keyboard::Q: dir = Direction::UP_LEFT; break;
+            case sf::Keyboard::E: dir = Direction::UP_RIGHT; break;
+            case sf::Keyboard::Z: dir = Direction::DOWN_LEFT; break;
+            case sf::Keyboard::C: dir = Direction::DOWN_RIGHT; break;
+            default: return;
         }
     }
-    
-    if (moved) {
-        addRandomTile();
-        gameOver = isGameOver();
+    playMove(dir);
+}
+
+// 按键和自动玩家共用：移动、生成新方块、判断结束
+bool Game::playMove(Direction dir) {
+    if (!moveTiles(directionDx(dir), directionDy(dir))) {
+        return false;
     }
+    addRandomTile();
+    gameOver = isGameOver();
+    if (gameOver) {
+        finishRecord();
+        updateGameOverText();
+    }
+    return true;
 }
 
 void Game::initializeGame(int size, GameVersion version) {
+    // 换棋盘前写出上一局
+    finishRecord();
     gridSize = size;
     currentVersion = version;
+    board = Board(gridSize, currentVersion);
+    autoPlayer.clearTable();
+    // 行表由后台线程生成；还没生成完时在这里等待，而不是在第一次移动时卡顿
+    movetable::table(gridSize, mergeRule(currentVersion));
     resetGame();
 }
 
 void Game::resetGame() {
-    grid.clear();
-    grid.resize(gridSize, std::vector<int>(gridSize, 0));
+    finishRecord();
+
+    // 每局从会话种子派生自己的种子，记下来即可重放这一局
+    gameSeed = seedSource.next();
+    rng = Rng(gameSeed);
+    if (recorder) {
+        currentRecord.begin(gridSize, currentVersion, gameSeed, true);
+        recordOpen = true;
+    }
+    board.reset();
+    gameStarted = true;
     score = 0;
     gameOver = false;
     gameWon = false;
+    sliding = false;
+    cellAnimations.mergedMask = 0;
+    cellAnimations.spawnMask = 0;
     
     // 计算新的网格布局
     calculateGridLayout();
+    boardVerticesDirty = true;
     
     // 添加初始方块
     addRandomTile();
@@ -327,274 +609,158 @@ void Game::resetGame() {
 }
 
 void Game::addRandomTile() {
-    std::vector<std::pair<int, int>> emptyCells;
-    
-    for (int y = 0; y < gridSize; ++y) {
-        for (int x = 0; x < gridSize; ++x) {
-            if (grid[y][x] == 0) {
-                emptyCells.emplace_back(x, y);
-            }
+    int cell = board.addRandomTile(rng);
+
+    if (cell >= 0) {
+        if (recordOpen) {
+            currentRecord.addSpawn(cell, board.getCell(cell));
         }
-    }
-    
-    if (!emptyCells.empty()) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dist(0, emptyCells.size() - 1);
-        
-        auto [x, y] = emptyCells[dist(gen)];
-        grid[y][x] = (dist(gen) % 10 < 8) ? 2 : 4;
-        
+
         // 添加新方块动画
-        newTileAnimations.push_back({
-            getTilePosition(x, y),
-            0.0f // 初始进度为0
-        });
+        cellAnimations.spawnProgress[cell] = 0.0f;
+        cellAnimations.spawnMask |= std::uint64_t(1) << cell;
+        boardVerticesDirty = true;
     }
 }
 
 bool Game::moveTiles(int dx, int dy) {
-    bool moved = false;
-    std::vector<std::vector<bool>> merged(gridSize, std::vector<bool>(gridSize, false));
-    tileAnimations.clear(); // 清空之前的动画记录
-
-    // 根据移动方向确定遍历顺序
-    const bool horizontal = (dx != 0);
-    const int start = (dx > 0 || dy > 0) ? gridSize - 1 : 0;
-    const int step = (dx > 0 || dy > 0) ? -1 : 1;
-
-    // 遍历每个可能的行或列
-    for (int i = 0; i < gridSize; ++i) {
-        for (int j = start; j >= 0 && j < gridSize; j += step) {
-            // 获取当前格子的坐标
-            int x = horizontal ? j : i;
-            int y = horizontal ? i : j;
-            
-            if (grid[y][x] == 0) continue;
-
-            // 计算移动方向和目标位置
-            int newX = x;
-            int newY = y;
-            int prevX = x;
-            int prevY = y;
-            bool hasMerged = false;
-
-            while (true) {
-                int nextX = newX + dx;
-                int nextY = newY + dy;
-
-                // 边界检查
-                if (nextX < 0 || nextX >= gridSize || nextY < 0 || nextY >= gridSize) break;
-
-                // 如果目标位置为空，继续移动
-                if (grid[nextY][nextX] == 0) {
-                    prevX = newX;
-                    prevY = newY;
-                    newX = nextX;
-                    newY = nextY;
-                    moved = true;
-                } 
-                // 如果目标位置有相同值且未合并过
-                else if (grid[nextY][nextX] == grid[y][x] && !merged[nextY][nextX]) {
-                    merged[nextY][nextX] = true;
-                    grid[nextY][nextX] *= 2;
-                    score += grid[nextY][nextX];
-                    grid[y][x] = 0;
-                    moved = true;
-                    hasMerged = true;
-                    break;
-                } 
-                // 其他情况停止移动
-                else {
-                    break;
-                }
-            }
-
-            // 如果没有合并但移动了位置
-            if (!hasMerged && (newX != x || newY != y)) {
-                grid[newY][newX] = grid[y][x];
-                grid[y][x] = 0;
-                tileAnimations.emplace_back(getTilePosition(x, y), getTilePosition(newX, newY));
-                moved = true;
-            }
-
-            if (moved) {
-                tileAnimations.emplace_back(getTilePosition(x, y), getTilePosition(newX, newY));
-            }
-        }
+    std::array<std::uint8_t, Board::MAX_CELLS> before;
+    for (int cell = 0; cell < gridSize * gridSize; ++cell) {
+        before[cell] = static_cast<std::uint8_t>(board.getCell(cell));
     }
 
-    if (moved) {
-        animationProgress = 0.0f; // 重置动画进度
+    Board::MoveTrace trace;
+    const Direction dir = directionFromDelta(dx, dy);
+    if (!board.move(dir, &trace)) {
+        return false;
+    }
+    if (recordOpen) {
+        currentRecord.addMove(dir);
     }
 
-    return moved;
+    // 由引擎给出的逐格记录生成滑动动画；方块都换了位置，上一步的生成动画不再有效
+    cellAnimations.slideTarget = trace.target;
+    cellAnimations.slideExponent = before;
+    cellAnimations.mergedMask = trace.mergedMask;
+    cellAnimations.spawnMask = 0;
+    mergeProgress = 0.0f;
+    sliding = true;
+    animationProgress = 0.0f; // 重置动画进度
+
+    syncBoard();
+    return true;
 }
 
-// TODO: 实现连续合并版本的2048
+void Game::finishRecord() {
+    // 一步都没走的局不写
+    if (!recordOpen) return;
+    recordOpen = false;
+    if (currentRecord.moves.empty()) return;
+    currentRecord.finish(board);
+    recorder->write(currentRecord);
+}
 
-bool Game::moveTilesContinuous(int dx, int dy) {
-    bool moved = false;
-    
-    // 创建一个标记矩阵来跟踪哪些格子已经合并过
-    std::vector<std::vector<bool>> merged(gridSize, std::vector<bool>(gridSize, false));
-    
-    // 确定遍历顺序
-    int startX = (dx >= 0) ? 0 : gridSize - 1;
-    int endX = (dx >= 0) ? gridSize : -1;
-    int stepX = (dx >= 0) ? 1 : -1;
-    
-    int startY = (dy >= 0) ? 0 : gridSize - 1;
-    int endY = (dy >= 0) ? gridSize : -1;
-    int stepY = (dy >= 0) ? 1 : -1;
-    
-    for (int y = startY; y != endY; y += stepY) {
-        for (int x = startX; x != endX; x += stepX) {
-            if (grid[y][x] == 0) continue;
-            
-            int newX = x;
-            int newY = y;
-            int currentX = x;
-            int currentY = y;
-            bool canMerge = false;
-            
-            while (true) {
-                currentX += dx;
-                currentY += dy;
-                
-                if (currentX < 0 || currentX >= gridSize || 
-                    currentY < 0 || currentY >= gridSize) {
-                    break;
-                }
-                
-                if (grid[currentY][currentX] == 0) {
-                    newX = currentX;
-                    newY = currentY;
-                } else if (grid[currentY][currentX] == grid[y][x] && !merged[currentY][currentX]) {
-                    newX = currentX;
-                    newY = currentY;
-                    canMerge = true;
-                    break;
-                } else {
-                    break;
-                }
-            }
-            
-            if (newX != x || newY != y) {
-                if (canMerge) {
-                    // 合并方块
-                    grid[newY][newX] *= 2;
-                    score += grid[newY][newX];
-                    merged[newY][newX] = true; // 标记已合并
-                    if (grid[newY][newX] == 2048) {
-                        gameWon = true;
-                    }
-                } else {
-                    // 移动方块到空位
-                    grid[newY][newX] = grid[y][x];
-                }
-                
-                grid[y][x] = 0;
-                moved = true;
-            }
-        }
-    }
-    
-    return moved;
+void Game::syncBoard() {
+    score = board.getScore();
+    gameWon = board.hasWon();
+    boardVerticesDirty = true;
 }
-    
-bool Game::isGameOver() const {
-    if (currentVersion == GameVersion::ORIGINAL) {
-        return Game::isGameOver_grid();
+
+// 结束时设置一次提示文字，不在每帧重新构造
+void Game::updateGameOverText() {
+    if (!gameOver) return;
+    if (gameWon) {
+        gameOverText.setString("You Win!");
+        gameOverText.setFillColor(sf::Color(237, 194, 46));
     } else {
-        return Game::isGameOVer_diagonal();
+        gameOverText.setString("Game Over!");
+        gameOverText.setFillColor(sf::Color(119, 110, 101));
     }
+
+    sf::FloatRect textRect = gameOverText.getLocalBounds();
+    gameOverText.setOrigin(textRect.left + textRect.width/2.0f,
+                         textRect.top + textRect.height/2.0f);
+    gameOverText.setPosition(WINDOW_WIDTH/2, WINDOW_HEIGHT/2 - 30);
 }
 
-bool Game::isGameOVer_diagonal() const {
-    for (int y = 0; y < gridSize; ++y) {
-        for (int x = 0; x < gridSize; ++x) {
-            if (grid[y][x] == 0) {
-                return false;
-            }
+bool Game::isGameOver() const {
+    return board.isGameOver();
+}
+
+void Game::update(float dt) {
+    // 叠加层每 0.25 秒刷新一次，避免每帧重新排版文字
+    if (showProfiler) {
+        profilerRefresh += dt;
+        if (profilerRefresh >= 0.25f) {
+            profilerRefresh = 0.0f;
+            updateProfilerText();
         }
     }
-    for (int y = 0; y < gridSize; ++y) {
-        for (int x = 0; x < gridSize; ++x) {
-            int value = grid[y][x];
-            
-            // 检查右下方邻居
-            if (x < gridSize - 1 && y < gridSize - 1 && grid[y+1][x+1] == value) {
-                return false;
-            }
-            
-            // 检查左下方邻居
-            if (y < gridSize - 1 && x > 0 && grid[y+1][x-1] == value) {
-                return false;
-            }
-        }
+
+    // 分数变了才重写文字，不变时 setString 也省掉
+    if (score != displayedScore) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "Score: %d", score);
+        assignAscii(scoreString, buffer);
+        scoreText.setString(scoreString);
+        displayedScore = score;
     }
-    
-    return true;
-}
 
-bool Game::isGameOver_grid() const {
-    // 检查是否有空位
-    for (int y = 0; y < gridSize; ++y) {
-        for (int x = 0; x < gridSize; ++x) {
-            if (grid[y][x] == 0) {
-                return false;
-            }
-        }
+    // 有动画在播放时每一步都要重建顶点并重画，动画结束后的那一帧也要画
+    if (sliding || cellAnimations.mergedMask != 0 || cellAnimations.spawnMask != 0) {
+        boardVerticesDirty = true;
+        needsRedraw = true;
     }
-    
-    // 检查是否有可以合并的方块
-    for (int y = 0; y < gridSize; ++y) {
-        for (int x = 0; x < gridSize; ++x) {
-            int value = grid[y][x];
-            
-            // 检查右侧邻居
-            if (x < gridSize - 1 && grid[y][x+1] == value) {
-                return false;
-            }
-            
-            // 检查下方邻居
-            if (y < gridSize - 1 && grid[y+1][x] == value) {
-                return false;
-            }
+
+    // 自动玩家：上一步的滑动动画结束后再走下一步
+    if (autoPlay && currentState == GameState::GAME && !gameOver && !sliding) {
+        Direction dir;
+        bool found;
+        if (network && network->getGridSize() == gridSize) {
+            found = NTuplePlayer(*network).chooseMove(board, dir);
+        } else if (currentVersion == GameVersion::MODIFIED) {
+            found = rolloutPlayer.chooseMove(board, dir);
+        } else {
+            found = autoPlayer.chooseMove(board, dir);
+        }
+        if (found) {
+            playMove(dir);
         }
     }
-    
-    return true;
-}
 
-void Game::update() {
-    std::ostringstream ss;
-    ss << "Score: " << score;
-    scoreText.setString(ss.str());
-
-    if (!tileAnimations.empty()) {
-        animationProgress += (1.0f / (60.0f * animationDuration)); 
+    if (sliding) {
+        animationProgress += dt / animationDuration;
         if (animationProgress >= 1.0f) {
             animationProgress = 1.0f;
-            tileAnimations.clear();
+            sliding = false;
+        }
+    } else if (cellAnimations.mergedMask != 0) {
+        // 滑动结束后合并出的方块弹一下
+        mergeProgress += dt / MERGE_ANIMATION_DURATION;
+        if (mergeProgress >= 1.0f) {
+            mergeProgress = 1.0f;
+            cellAnimations.mergedMask = 0;
         }
     }
 
-    // 更新新方块生成动画
-    for (auto& anim : newTileAnimations) {
-        anim.progress += (1.0f / (60.0f * spawnAnimationDuration));
-        if (anim.progress > 1.0f) anim.progress = 1.0f;
+    // 更新新方块生成动画，完成的从掩码中移除。滑动时新方块只靠掩码画出来，要等滑动结束再移除。
+    // 掩码只保留棋盘上的格子，spawnProgress 不会越界
+    cellAnimations.spawnMask &= (std::uint64_t(1) << board.getCellCount()) - 1;
+    for (std::uint64_t spawning = cellAnimations.spawnMask; spawning != 0; spawning &= spawning - 1) {
+        const int cell = std::countr_zero(spawning);
+        float& progress = cellAnimations.spawnProgress[cell];
+        progress += dt / spawnAnimationDuration;
+        if (progress >= 1.0f) {
+            progress = 1.0f;
+            if (!sliding) {
+                cellAnimations.spawnMask &= ~(std::uint64_t(1) << cell);
+            }
+        }
     }
-    // 移除已完成的动画
-    newTileAnimations.erase(
-        std::remove_if(newTileAnimations.begin(), newTileAnimations.end(),
-            [](const NewTileAnimation& a) { return a.progress >= 1.0f; }),
-        newTileAnimations.end()
-    );
 }
 
 void Game::render() {
+    FrameProfiler::Scope scope(profiler, "render");
     window.clear(sf::Color(187, 173, 160));
     
     // 先渲染当前界面
@@ -610,7 +776,7 @@ void Game::render() {
             break;
         case GameState::EXIT_CONFIRM:
             // 退出确认时仍然显示之前的界面作为背景
-            if (!grid.empty()) {
+            if (gameStarted) {
                 renderGame();
             } else if (currentState == GameState::VERSION_MENU) {
                 renderVersionMenu();
@@ -622,167 +788,188 @@ void Game::render() {
     
     // 如果是退出确认状态，再渲染确认对话框
     if (currentState == GameState::EXIT_CONFIRM) {
-        window.draw(exitConfirmBackground);
-        window.draw(exitConfirmBox);
-        window.draw(exitConfirmText);
-        window.draw(exitConfirmYesButton);
-        window.draw(exitConfirmNoButton);
-        window.draw(exitConfirmYesText);
-        window.draw(exitConfirmNoText);
+        draw(exitConfirmBackground);
+        draw(exitConfirmBox);
+        draw(exitConfirmText);
+        draw(exitConfirmYesButton);
+        draw(exitConfirmNoButton);
+        draw(exitConfirmYesText);
+        draw(exitConfirmNoText);
     }
-    
+
+    if (showProfiler) {
+        FrameProfiler::Scope profilerScope(profiler, "profiler");
+        draw(profilerBackground);
+        draw(profilerText);
+    }
+
+    // 含帧率限制的等待和交换缓冲区
+    FrameProfiler::Scope displayScope(profiler, "display");
     window.display();
 }
 
 void Game::renderMainMenu() {
-    window.draw(titleText);
+    draw(titleText);
     for (const auto& button : sizeButtons) {
-        window.draw(button);
+        draw(button);
     }
     for (const auto& text : sizeButtonTexts) {
-        window.draw(text);
+        draw(text);
     }
 }
 
 void Game::renderVersionMenu() {
-    window.draw(versionTitleText);
+    draw(versionTitleText);
     for (const auto& button : versionButtons) {
-        window.draw(button);
+        draw(button);
     }
     for (const auto& text : versionButtonTexts) {
-        window.draw(text);
+        draw(text);
     }
 }
 
 void Game::renderGame() {
     // 绘制分数
-    window.draw(scoreText);
+    {
+        FrameProfiler::Scope scope(profiler, "text");
+        draw(scoreText);
+    }
+
+    // 背景、方块和数字一次绘制
+    if (boardVerticesDirty) {
+        FrameProfiler::Scope scope(profiler, "vertices");
+        rebuildBoardVertices();
+    }
+    {
+        FrameProfiler::Scope scope(profiler, "board");
+        draw(boardVertices, &labelAtlas.getTexture());
+    }
     
-    // 绘制网格背景
-    if (currentVersion == GameVersion::ORIGINAL) {
-        // 原始版本 - 绘制整体背景和网格线
-        sf::RectangleShape gridBackground(sf::Vector2f(
-            gridSize * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN,
-            gridSize * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN
-        ));
-        gridBackground.setPosition(GRID_OFFSET_X, GRID_OFFSET_Y);
-        gridBackground.setFillColor(sf::Color(143, 122, 102));
-        window.draw(gridBackground);
+    // 绘制游戏结束/胜利消息（保持不变）
+    if (gameOver) {
+        FrameProfiler::Scope scope(profiler, "overlay");
+        draw(gameOverOverlay);
+        draw(gameOverText);
+        draw(restartText);
+    }
+}
+
+void Game::rebuildBoardVertices() {
+    if (board.getMaxExponent() > labelAtlasMaxExponent) {
+        buildLabelAtlas(board.getMaxExponent());
+    }
+    boardVertices.clear();
+
+    // 纯色矩形采样图集第 0 格的白色像素
+    const sf::FloatRect solid(TILE_SIZE / 2.0f, TILE_SIZE / 2.0f, 0.0f, 0.0f);
+
+    // 网格背景
+    const float gridExtent = gridSize * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN;
+    if (currentVersion != GameVersion::MODIFIED) {
+        // 原始版本 - 整体背景
+        appendRect(boardVertices, sf::FloatRect(GRID_OFFSET_X, GRID_OFFSET_Y, gridExtent, gridExtent), solid,
+                   sf::Color(143, 122, 102));
     } else {
-        // 修改版本 - 绘制黑白棋盘背景
+        // 修改版本 - 黑白棋盘背景
         for (int y = 0; y < gridSize; ++y) {
             for (int x = 0; x < gridSize; ++x) {
-                sf::RectangleShape cellBackground(sf::Vector2f(
-                    TILE_SIZE + TILE_MARGIN, 
-                    TILE_SIZE + TILE_MARGIN
-                ));
-                cellBackground.setPosition(
-                    GRID_OFFSET_X + x * (TILE_SIZE + TILE_MARGIN),
-                    GRID_OFFSET_Y + y * (TILE_SIZE + TILE_MARGIN)
-                );
-                cellBackground.setFillColor(getCellBackgroundColor(x, y));
-                window.draw(cellBackground);
+                appendRect(boardVertices,
+                           sf::FloatRect(GRID_OFFSET_X + x * (TILE_SIZE + TILE_MARGIN),
+                                         GRID_OFFSET_Y + y * (TILE_SIZE + TILE_MARGIN),
+                                         TILE_SIZE + TILE_MARGIN, TILE_SIZE + TILE_MARGIN),
+                           solid, getCellBackgroundColor(x, y));
             }
         }
     }
-    
-    // 绘制数字格子
-    for (int y = 0; y < gridSize; ++y) {
-        for (int x = 0; x < gridSize; ++x) {
-            if (grid[y][x] != 0) {
-                sf::RectangleShape tile(sf::Vector2f(TILE_SIZE, TILE_SIZE));
-                
-                // 调整位置 - 修改版本需要居中
-                sf::Vector2f position;
-                if (currentVersion == GameVersion::MODIFIED) {
-                    position = sf::Vector2f(
-                        GRID_OFFSET_X + x * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN/2,
-                        GRID_OFFSET_Y + y * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN/2
-                    );
-                } else {
-                    position = sf::Vector2f(
-                        GRID_OFFSET_X + TILE_MARGIN + x * (TILE_SIZE + TILE_MARGIN),
-                        GRID_OFFSET_Y + TILE_MARGIN + y * (TILE_SIZE + TILE_MARGIN)
-                    );
-                }
 
-                float scale = 1.0f;
-                for (const auto& anim : newTileAnimations) {
-                    if (position == anim.position) {
-                        // 使用缓动函数实现更平滑的动画
-                        scale = 0.2f + 0.8f * std::sin(anim.progress * 3.14159f/2);
-                        break;
-                    }
-                }
-                tile.setScale(scale, scale);
-
-                // 如果有动画，根据动画进度更新位置
-                for (size_t i = 0; i < tileAnimations.size(); ++i) {
-                    if (getTilePosition(x, y) == tileAnimations[i].first) {
-                        position.x = tileAnimations[i].first.x + (tileAnimations[i].second.x - tileAnimations[i].first.x) * animationProgress;
-                        position.y = tileAnimations[i].first.y + (tileAnimations[i].second.y - tileAnimations[i].first.y) * animationProgress;
-                        break;
-                    }
-                }
+    // 以方块中心为基准缩放，数字贴图与方块同大小，随方块一起缩放
+    auto appendTile = [&](const sf::Vector2f& position, int exponent, float scale) {
+        const float half = TILE_SIZE * scale / 2.0f;
+        const sf::FloatRect rect(position.x + TILE_SIZE/2.0f - half, position.y + TILE_SIZE/2.0f - half,
+                                 2 * half, 2 * half);
+        appendRect(boardVertices, rect, solid, getTileColor(1 << std::min(exponent, 12)));
+        appendRect(boardVertices, rect, getLabelRect(exponent), sf::Color::White);
+    };
+    // 使用缓动函数实现更平滑的生成动画
+    auto spawnScale = [&](int cell) {
+        return 0.2f + 0.8f * std::sin(cellAnimations.spawnProgress[cell] * 3.14159f/2);
+    };
 
-                // 调整位置中心点以保持居中缩放
-                tile.setOrigin(TILE_SIZE/2 * (1 - scale), TILE_SIZE/2 * (1 - scale)); 
-
-                tile.setPosition(position);
-                tile.setFillColor(getTileColor(grid[y][x]));
-                window.draw(tile);
-                
-                // 绘制数字
-                sf::Text valueText;
-                valueText.setFont(font);
-                valueText.setString(std::to_string(grid[y][x]));
-                valueText.setCharacterSize(32);
-                valueText.setFillColor(grid[y][x] < 8 ? sf::Color(119, 110, 101) : sf::Color(249, 246, 242));
-                
-                sf::FloatRect textRect = valueText.getLocalBounds();
-                valueText.setOrigin(textRect.left + textRect.width/2.0f,
-                                  textRect.top + textRect.height/2.0f);
-                
-                // 调整数字位置 - 修改版本需要居中
-                if (currentVersion == GameVersion::MODIFIED) {
-                    valueText.setPosition(
-                        position.x + TILE_SIZE/2,
-                        position.y + TILE_SIZE/2
-                    );
-                } else {
-                    valueText.setPosition(
-                        position.x + TILE_SIZE/2,
-                        position.y + TILE_SIZE/2
-                    );
-                }
-                
-                window.draw(valueText);
+    const int cellCount = gridSize * gridSize;
+    if (sliding) {
+        // 滑动中：画移动前的方块，从原格子插值到目标格子
+        for (int cell = 0; cell < cellCount; ++cell) {
+            const int exponent = cellAnimations.slideExponent[cell];
+            if (exponent == 0) continue;
+            const int target = cellAnimations.slideTarget[cell];
+            const sf::Vector2f from = getTilePosition(cell % gridSize, cell / gridSize);
+            const sf::Vector2f to = getTilePosition(target % gridSize, target / gridSize);
+            appendTile(from + (to - from) * animationProgress, exponent, 1.0f);
+        }
+        for (std::uint64_t spawning = cellAnimations.spawnMask; spawning != 0; spawning &= spawning - 1) {
+            const int cell = std::countr_zero(spawning);
+            appendTile(getTilePosition(cell % gridSize, cell / gridSize), board.getCell(cell), spawnScale(cell));
+        }
+    } else {
+        for (int cell = 0; cell < cellCount; ++cell) {
+            const int exponent = board.getCell(cell);
+            if (exponent == 0) continue;
+            const std::uint64_t bit = std::uint64_t(1) << cell;
+            float scale = 1.0f;
+            if (cellAnimations.spawnMask & bit) {
+                scale = spawnScale(cell);
+            } else if (cellAnimations.mergedMask & bit) {
+                scale = 1.0f + 0.15f * std::sin(mergeProgress * 3.14159f);
             }
+            appendTile(getTilePosition(cell % gridSize, cell / gridSize), exponent, scale);
         }
     }
-    
-    // 绘制游戏结束/胜利消息（保持不变）
-    if (gameOver) {
-        sf::RectangleShape overlay(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
-        overlay.setFillColor(sf::Color(0, 0, 0, 150));
-        window.draw(overlay);
-        
-        if (gameWon) {
-            gameOverText.setString("You Win!");
-            gameOverText.setFillColor(sf::Color(237, 194, 46));
-        } else {
-            gameOverText.setString("Game Over!");
-            gameOverText.setFillColor(sf::Color(119, 110, 101));
+
+    boardVerticesDirty = false;
+}
+
+void Game::buildLabelAtlas(int maxExponent) {
+    labelAtlasMaxExponent = std::max(maxExponent, DEFAULT_LABEL_EXPONENT);
+    const int slots = labelAtlasMaxExponent + 1;
+    labelAtlasColumns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(slots))));
+    const int rows = (slots + labelAtlasColumns - 1) / labelAtlasColumns;
+    if (!labelAtlas.create(labelAtlasColumns * TILE_SIZE, rows * TILE_SIZE)) {
+        throw std::runtime_error("Failed to create label atlas");
+    }
+    labelAtlas.clear(sf::Color::Transparent);
+
+    sf::RectangleShape white(sf::Vector2f(TILE_SIZE, TILE_SIZE));
+    white.setFillColor(sf::Color::White);
+    labelAtlas.draw(white);
+
+    sf::Text valueText;
+    valueText.setFont(font);
+    for (int exponent = 1; exponent <= labelAtlasMaxExponent; ++exponent) {
+        const std::uint64_t value = std::uint64_t(1) << exponent;
+        valueText.setString(std::to_string(value));
+        valueText.setCharacterSize(LABEL_CHARACTER_SIZE);
+        valueText.setFillColor(value < 8 ? sf::Color(119, 110, 101) : sf::Color(249, 246, 242));
+
+        sf::FloatRect textRect = valueText.getLocalBounds();
+        const float maxWidth = TILE_SIZE * 0.9f;
+        if (textRect.width > maxWidth) {
+            valueText.setCharacterSize(static_cast<unsigned>(LABEL_CHARACTER_SIZE * maxWidth / textRect.width));
+            textRect = valueText.getLocalBounds();
         }
-        
-        sf::FloatRect textRect = gameOverText.getLocalBounds();
-        gameOverText.setOrigin(textRect.left + textRect.width/2.0f,
-                             textRect.top + textRect.height/2.0f);
-        gameOverText.setPosition(WINDOW_WIDTH/2, WINDOW_HEIGHT/2 - 30);
-        
-        window.draw(gameOverText);
-        window.draw(restartText);
+        valueText.setOrigin(textRect.left + textRect.width/2.0f,
+                          textRect.top + textRect.height/2.0f);
+
+        const sf::FloatRect slot = getLabelRect(exponent);
+        valueText.setPosition(slot.left + TILE_SIZE/2.0f, slot.top + TILE_SIZE/2.0f);
+        labelAtlas.draw(valueText);
     }
+    labelAtlas.display();
+    boardVerticesDirty = true;
+}
+
+sf::FloatRect Game::getLabelRect(int exponent) const {
+    return sf::FloatRect((exponent % labelAtlasColumns) * TILE_SIZE, (exponent / labelAtlasColumns) * TILE_SIZE,
+                         TILE_SIZE, TILE_SIZE);
 }
 
 // 在构造函数之后添加这些函数实现
@@ -804,12 +991,22 @@ void Game::calculateGridLayout() {
     // 计算网格起始位置（居中偏下）
     GRID_OFFSET_X = (WINDOW_WIDTH - (gridSize * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN)) / 2;
     GRID_OFFSET_Y = WINDOW_HEIGHT * 0.6f - (gridSize * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN) / 2;
+
+    // 方块尺寸变了，按新尺寸重新渲染数字图集
+    buildLabelAtlas(board.getMaxExponent());
 }
 
 sf::Vector2f Game::getTilePosition(int x, int y) const {
+    // 修改版本方块在棋盘格中居中
+    if (currentVersion == GameVersion::MODIFIED) {
+        return sf::Vector2f(
+            GRID_OFFSET_X + x * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN/2,
+            GRID_OFFSET_Y + y * (TILE_SIZE + TILE_MARGIN) + TILE_MARGIN/2
+        );
+    }
     return sf::Vector2f(
-        GRID_OFFSET_X + x * (TILE_SIZE + TILE_MARGIN),
-        GRID_OFFSET_Y + y * (TILE_SIZE + TILE_MARGIN)
+        GRID_OFFSET_X + TILE_MARGIN + x * (TILE_SIZE + TILE_MARGIN),
+        GRID_OFFSET_Y + TILE_MARGIN + y * (TILE_SIZE + TILE_MARGIN)
     );
 }
 
@@ -2,9 +2,16 @@
 #define GAME2048_H
 
 #include <SFML/Graphics.hpp>
-#include <vector>
+#include "Board.h"
+#include "Expectimax.h"
+#include "FrameProfiler.h"
+#include "MonteCarlo.h"
+#include "GameRecord.h"
+#include "NTuple.h"
 #include <array>
 #include <algorithm>
+#include <string>
+#include <thread>
 
 enum class GameState {
     MAIN_MENU,
@@ -13,16 +20,33 @@ enum class GameState {
     EXIT_CONFIRM,
 };
 
-enum class GameVersion {
-    ORIGINAL,
-    MODIFIED
+// 显示设置：帧率上限和垂直同步二选一即可，都关闭时主循环不限速
+struct DisplayOptions {
+    unsigned frameLimit = 60; // 0 表示不限制
+    bool verticalSync = false;
+    std::size_t traceFrames = 600; // 性能分析保留最近多少帧
+    std::string tracePath;         // 非空时退出时把这些帧写成 Chrome trace，F4 也写到这里
 };
 
 class Game {
 public:
-    Game();
+    // recorder 非空时每一局（含生成记录）都写入对局记录；
+    // network 非空时，同尺寸棋盘的自动玩家改用 n-tuple 一层贪心
+    explicit Game(std::uint64_t seed, const DisplayOptions& display = DisplayOptions(),
+                  record::RecordWriter* recorder = nullptr, const NTupleNetwork* network = nullptr);
+    ~Game();
     void run();
 
+    // 基准测试用：把 position 摆上棋盘（不播放动画）后连续渲染 frames 帧；
+    // rebuild 为真时每帧都重建顶点数组，相当于动画进行中的帧
+    void renderFrames(const Board& position, int frames, bool rebuild);
+    // 基准测试用：把 position 摆上棋盘后按 dir 走一步（与按键相同：移动、生成、结束判断），
+    // 再推进一个固定步长；返回是否走动。稳定运行时整个过程不分配内存
+    bool playInput(const Board& position, Direction dir);
+
+    // 有动画在播放时为真，主循环据此决定是否阻塞等待事件；刚构造、还没开始游戏时应为假
+    bool isAnimating() const;
+
 private:
     // Window and state
     sf::RenderWindow window;
@@ -30,24 +54,71 @@ private:
     GameVersion currentVersion;
     int gridSize;
 
-    // 在原有动画相关成员变量旁添加
-    struct NewTileAnimation {
-        sf::Vector2f position;
-        float progress;
+    // 动画状态按格子下标（y * gridSize + x）平铺存放，由 Board::move 的记录直接生成，
+    // 渲染时每个方块 O(1) 取到自己的动画
+    struct CellAnimations {
+        std::array<std::uint8_t, Board::MAX_CELLS> slideTarget;   // 滑动前第 c 格的方块滑到的格子
+        std::array<std::uint8_t, Board::MAX_CELLS> slideExponent; // 滑动前第 c 格方块的指数，0 表示空格
+        std::array<float, Board::MAX_CELLS> spawnProgress;        // 第 c 格新方块的生成动画进度
+        std::uint64_t mergedMask;                                 // 移动后由合并产生的格子
+        std::uint64_t spawnMask;                                  // 正在播放生成动画的格子
     };
-    std::vector<NewTileAnimation> newTileAnimations;
-    float spawnAnimationDuration = 0.3f; // 新方块生成动画持续时间
+    CellAnimations cellAnimations;
+    float spawnAnimationDuration = 0.3f; // 新方块生成动画持续时间，单位为秒
 
     // 动画相关
-    std::vector<std::pair<sf::Vector2f, sf::Vector2f>> tileAnimations; // 存储每个方块的起始和目标位置
+    bool sliding;            // 滑动动画是否在播放
     float animationProgress; // 动画进度，范围从 0 到 1
     float animationDuration; // 动画持续时间，单位为秒
+    float mergeProgress;     // 滑动结束后合并方块弹跳的进度
+
+    // 性能分析：F3 开关叠加显示，F4 导出最近若干帧的 Chrome trace
+    FrameProfiler profiler;
+    bool showProfiler;
+    float profilerRefresh; // 距上次刷新叠加文字的时间
+    std::string tracePath;
+    sf::RectangleShape profilerBackground;
+    sf::Text profilerText;
+    sf::String profilerString;
+
+    // 输入、状态切换和动画推进时置位；为假且没有动画时主循环阻塞等待事件，不再重画
+    bool needsRedraw;
+    
+    // 网格背景、方块和数字合成一个顶点数组，只在网格或动画变化时重建
+    sf::VertexArray boardVertices;
+    bool boardVerticesDirty;
+
+    // 数字图集：第 e 格是数值 2^e 的标签，第 0 格为纯白供纯色矩形使用。
+    // 在 calculateGridLayout 时按当前 TILE_SIZE 预先渲染
+    sf::RenderTexture labelAtlas;
+    int labelAtlasColumns;
+    int labelAtlasMaxExponent;
     
     // Game data
-    std::vector<std::vector<int>> grid;
+    Board board; // 规则引擎，渲染直接读取其中按字节存的指数
+    bool gameStarted; // 进入过游戏界面，退出确认后回到游戏而不是主菜单
     int score;
     bool gameOver;
     bool gameWon;
+
+    // 自动玩家（游戏中按 A 开关）
+    ExpectimaxPlayer autoPlayer;
+    MonteCarloPlayer rolloutPlayer; // 修改版用 rollout，期望最大化的估值针对原版设计
+    const NTupleNetwork* network;
+    bool autoPlay;
+
+    // 随机数：会话种子派生每局的种子
+    Rng seedSource;
+    Rng rng;
+    std::uint64_t gameSeed;
+
+    // 启动时在后台生成 4-6 格的行表（6 格的表要几百毫秒），主菜单期间不卡界面
+    std::thread tableWarmup;
+
+    // 对局记录
+    record::RecordWriter* recorder;
+    record::GameRecord currentRecord;
+    bool recordOpen; // 当前局还没有写出
     
     // Resources
     sf::Font font;
@@ -61,11 +132,14 @@ private:
     
     // UI Elements - Version Menu
     sf::Text versionTitleText;
-    std::array<sf::RectangleShape, 2> versionButtons;
-    std::array<sf::Text, 2> versionButtonTexts;
+    std::array<sf::RectangleShape, 3> versionButtons;
+    std::array<sf::Text, 3> versionButtonTexts;
     
     // Game UI
     sf::Text scoreText;
+    sf::String scoreString; // 分数变化时原地改写，容量够用后不再分配
+    int displayedScore;     // scoreText 当前显示的分数
+    sf::RectangleShape gameOverOverlay;
     sf::Text gameOverText;
     sf::Text restartText;
 
@@ -85,13 +159,20 @@ private:
     
     // Core functions
     void processEvents();
-    void update();
+    void handleEvent(const sf::Event& event);
+    void update(float dt); // 按固定步长推进，dt 单位为秒
     void render();
+    void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default);
+    void updateProfilerText();
+    void writeTrace();
     
     // State rendering
     void renderMainMenu();
     void renderVersionMenu();
     void renderGame();
+    void rebuildBoardVertices();
+    void buildLabelAtlas(int maxExponent);
+    sf::FloatRect getLabelRect(int exponent) const;
 
     void calculateGridLayout();
     sf::Vector2f getTilePosition(int x, int y) const;
@@ -104,12 +185,14 @@ private:
     // Game logic
     void initializeGame(int size, GameVersion version);
     void resetGame();
+    void loadPosition(const Board& position);
     void addRandomTile();
+    bool playMove(Direction dir);
     bool moveTiles(int dx, int dy);
-    bool moveTilesContinuous(int dx, int dy);
     bool isGameOver() const;
-    bool isGameOver_grid() const;
-    bool isGameOVer_diagonal() const;
+    void syncBoard();
+    void updateGameOverText();
+    void finishRecord();
     
     // Helper functions
     void initializeUI();
@@ -0,0 +1,320 @@
+#include "GameRecord.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace record {
+
+namespace {
+
+void putU32(std::uint8_t* out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+void putU64(std::uint8_t* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint32_t getU32(const std::uint8_t* data) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+std::uint64_t getU64(const std::uint8_t* data) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+void encodeFileHeader(std::uint8_t* out) {
+    std::memcpy(out, FILE_MAGIC.data(), FILE_MAGIC.size());
+    putU32(out + FILE_MAGIC.size(), FORMAT_VERSION);
+}
+
+std::uint32_t fileVersion(const std::uint8_t* header) {
+    return getU32(header + FILE_MAGIC.size());
+}
+
+// 解析文件最后 INDEX_TRAILER_SIZE 字节。索引项数和记录区结束偏移要与文件大小对得上，
+// 没有正常关闭的文件恰好以这样的字节结尾几乎不可能
+bool decodeTrailer(const std::uint8_t* trailer, std::uint64_t fileSize, std::uint64_t& count, std::uint64_t& recordsEnd) {
+    if (std::memcmp(trailer + 16, INDEX_MAGIC.data(), INDEX_MAGIC.size()) != 0) {
+        return false;
+    }
+    count = getU64(trailer);
+    recordsEnd = getU64(trailer + 8);
+    return recordsEnd >= FILE_HEADER_SIZE && recordsEnd <= fileSize
+        && count <= (fileSize - recordsEnd) / 8
+        && recordsEnd + 8 * count + INDEX_TRAILER_SIZE == fileSize;
+}
+
+} // namespace
+
+std::size_t bodySize(const RecordHeader& header) {
+    std::size_t size = header.moveCount;
+    if (header.flags & FLAG_SPAWNS) {
+        size += 2 * (std::size_t(header.moveCount) + 2);
+    }
+    return size;
+}
+
+void encodeHeader(const RecordHeader& header, std::uint8_t* out) {
+    out[0] = static_cast<std::uint8_t>(header.gridSize);
+    out[1] = static_cast<std::uint8_t>(header.version);
+    out[2] = header.flags;
+    out[3] = static_cast<std::uint8_t>(header.maxExponent);
+    putU64(out + 4, header.seed);
+    putU32(out + 12, header.score);
+    putU32(out + 16, header.moveCount);
+}
+
+bool decodeHeader(const std::uint8_t* data, RecordHeader& header) {
+    header.gridSize = data[0];
+    header.version = static_cast<GameVersion>(data[1]);
+    header.flags = data[2];
+    header.maxExponent = data[3];
+    header.seed = getU64(data + 4);
+    header.score = getU32(data + 12);
+    header.moveCount = getU32(data + 16);
+    return movetable::supports(header.gridSize)
+        && data[1] <= static_cast<std::uint8_t>(GameVersion::CONTINUOUS)
+        && (header.flags & ~FLAG_SPAWNS) == 0;
+}
+
+bool checkFileHeader(const std::uint8_t* data, std::size_t size) {
+    return size >= FILE_HEADER_SIZE
+        && std::memcmp(data, FILE_MAGIC.data(), FILE_MAGIC.size()) == 0
+        && fileVersion(data) >= 1 && fileVersion(data) <= FORMAT_VERSION;
+}
+
+bool readIndex(const std::uint8_t* data, std::size_t size, std::size_t& recordsEnd, std::vector<std::size_t>& starts) {
+    std::uint64_t count;
+    std::uint64_t end;
+    if (!checkFileHeader(data, size) || fileVersion(data) < 2 || size < FILE_HEADER_SIZE + INDEX_TRAILER_SIZE
+        || !decodeTrailer(data + size - INDEX_TRAILER_SIZE, size, count, end)) {
+        return false;
+    }
+    // 索引项从第一条记录开始严格递增，且都落在记录区内
+    starts.clear();
+    for (std::uint64_t i = 0; i < count; ++i) {
+        const std::uint64_t offset = getU64(data + end + 8 * i);
+        if (offset >= end || (i == 0 ? offset != FILE_HEADER_SIZE : offset <= starts.back())) {
+            return false;
+        }
+        starts.push_back(static_cast<std::size_t>(offset));
+    }
+    if (count == 0 && end != FILE_HEADER_SIZE) {
+        return false;
+    }
+    recordsEnd = static_cast<std::size_t>(end);
+    return true;
+}
+
+void GameRecord::begin(int gridSize, GameVersion version, std::uint64_t seed, bool withSpawns) {
+    header = RecordHeader{gridSize, version, static_cast<std::uint8_t>(withSpawns ? FLAG_SPAWNS : 0), 0, seed, 0, 0};
+    moves.clear();
+    spawns.clear();
+}
+
+void GameRecord::finish(const Board& board) {
+    header.score = static_cast<std::uint32_t>(board.getScore());
+    header.maxExponent = std::min(board.getMaxExponent(), 255);
+    header.moveCount = static_cast<std::uint32_t>(moves.size());
+}
+
+RecordWriter::RecordWriter(const std::string& path, std::size_t bufferSize)
+    : file(path, std::ios::binary | std::ios::trunc),
+      bufferSize(bufferSize),
+      flushedBytes(0),
+      recordCount(0),
+      closing(false),
+      closed(false),
+      failed(false) {
+    if (!file) {
+        throw std::runtime_error("Failed to open record file: " + path);
+    }
+    current.reserve(bufferSize);
+    current.resize(FILE_HEADER_SIZE);
+    encodeFileHeader(current.data());
+    worker = std::thread(&RecordWriter::run, this);
+}
+
+RecordWriter::~RecordWriter() {
+    try {
+        close();
+    } catch (...) {
+        // 析构时无法报告错误，需要确认写盘结果时应显式调用 close
+    }
+}
+
+void RecordWriter::write(const GameRecord& record) {
+    RecordHeader header = record.header;
+    header.moveCount = static_cast<std::uint32_t>(record.moves.size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::size_t offset = current.size();
+    if (recordCount++ % INDEX_INTERVAL == 0) {
+        index.push_back(flushedBytes + offset);
+    }
+    current.resize(offset + RECORD_HEADER_SIZE + bodySize(header));
+    std::uint8_t* out = current.data() + offset;
+    encodeHeader(header, out);
+    out += RECORD_HEADER_SIZE;
+    std::copy(record.moves.begin(), record.moves.end(), out);
+    out += record.moves.size();
+    if (header.flags & FLAG_SPAWNS) {
+        // 生成记录缺失（例如中途结束的对局）时用 0 补齐，保持记录长度与头部一致
+        for (std::size_t i = 0; i < std::size_t(header.moveCount) + 2; ++i) {
+            const std::uint16_t spawn = i < record.spawns.size() ? record.spawns[i] : 0;
+            out[2 * i] = static_cast<std::uint8_t>(spawn);
+            out[2 * i + 1] = static_cast<std::uint8_t>(spawn >> 8);
+        }
+    }
+
+    if (current.size() >= bufferSize) {
+        flushedBytes += current.size();
+        pending.push_back(std::move(current));
+        current = std::vector<std::uint8_t>();
+        current.reserve(bufferSize);
+        ready.notify_one();
+    }
+}
+
+void RecordWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) return;
+        closed = true;
+        closing = true;
+
+        // 末尾写出索引，分析时可以直接按索引分块
+        const std::uint64_t recordsEnd = flushedBytes + current.size();
+        const std::size_t at = current.size();
+        current.resize(at + 8 * index.size() + INDEX_TRAILER_SIZE);
+        std::uint8_t* out = current.data() + at;
+        for (std::uint64_t offset : index) {
+            putU64(out, offset);
+            out += 8;
+        }
+        putU64(out, index.size());
+        putU64(out + 8, recordsEnd);
+        std::memcpy(out + 16, INDEX_MAGIC.data(), INDEX_MAGIC.size());
+        pending.push_back(std::move(current));
+        current.clear();
+    }
+    ready.notify_one();
+    worker.join();
+
+    file.flush();
+    failed = failed || !file;
+    file.close();
+    if (failed) {
+        throw std::runtime_error("Failed to write record file");
+    }
+}
+
+void RecordWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this] { return !pending.empty() || closing; });
+        while (!pending.empty()) {
+            std::vector<std::uint8_t> chunk = std::move(pending.front());
+            pending.pop_front();
+            // 写盘时不持有锁，write 可以继续往新缓冲区里追加
+            lock.unlock();
+            file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+            const bool ok = static_cast<bool>(file);
+            lock.lock();
+            failed = failed || !ok;
+        }
+        if (closing) {
+            return;
+        }
+    }
+}
+
+RecordReader::RecordReader(const std::string& path, std::size_t bufferSize)
+    : file(path, std::ios::binary),
+      buffer(std::max(bufferSize, FILE_HEADER_SIZE + RECORD_HEADER_SIZE)),
+      begin(0),
+      end(0),
+      unread(0) {
+    if (!file) {
+        throw std::runtime_error("Failed to open record file: " + path);
+    }
+    std::array<std::uint8_t, FILE_HEADER_SIZE> header;
+    if (!file.read(reinterpret_cast<char*>(header.data()), FILE_HEADER_SIZE)
+        || !checkFileHeader(header.data(), FILE_HEADER_SIZE)) {
+        throw std::runtime_error("Not a game record file: " + path);
+    }
+
+    // 有索引时只读到记录区末尾
+    file.seekg(0, std::ios::end);
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+    std::uint64_t recordsEnd = fileSize;
+    if (fileVersion(header.data()) >= 2 && fileSize >= FILE_HEADER_SIZE + INDEX_TRAILER_SIZE) {
+        std::array<std::uint8_t, INDEX_TRAILER_SIZE> trailer;
+        std::uint64_t count;
+        std::uint64_t end;
+        file.seekg(static_cast<std::streamoff>(fileSize - INDEX_TRAILER_SIZE));
+        if (file.read(reinterpret_cast<char*>(trailer.data()), INDEX_TRAILER_SIZE)
+            && decodeTrailer(trailer.data(), fileSize, count, end)) {
+            recordsEnd = end;
+        }
+        file.clear();
+    }
+    file.seekg(static_cast<std::streamoff>(FILE_HEADER_SIZE));
+    unread = recordsEnd - FILE_HEADER_SIZE;
+}
+
+bool RecordReader::next(RecordView& view) {
+    if (!fill(RECORD_HEADER_SIZE)) {
+        if (begin == end) {
+            return false;
+        }
+        throw std::runtime_error("Truncated game record");
+    }
+    if (!decodeHeader(buffer.data() + begin, view.header)) {
+        throw std::runtime_error("Corrupt game record");
+    }
+    const std::size_t size = RECORD_HEADER_SIZE + bodySize(view.header);
+    if (!fill(size)) {
+        throw std::runtime_error("Truncated game record");
+    }
+    view.body = buffer.data() + begin + RECORD_HEADER_SIZE;
+    begin += size;
+    return true;
+}
+
+bool RecordReader::fill(std::size_t needed) {
+    if (end - begin >= needed) {
+        return true;
+    }
+    // 未读部分移到缓冲区开头，放不下一整条记录时扩容
+    std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+    end -= begin;
+    begin = 0;
+    if (buffer.size() < needed) {
+        buffer.resize(needed);
+    }
+    while (end < needed && unread > 0 && file) {
+        const std::uint64_t want = std::min<std::uint64_t>(buffer.size() - end, unread);
+        file.read(reinterpret_cast<char*>(buffer.data() + end), static_cast<std::streamsize>(want));
+        const std::size_t got = static_cast<std::size_t>(file.gcount());
+        end += got;
+        unread -= got;
+        if (got == 0) break;
+    }
+    return end >= needed;
+}
+
+} // namespace record
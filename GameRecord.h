@@ -0,0 +1,186 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include "Board.h"
+#include "Rng.h"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 二进制对局记录。文件由 12 字节文件头、若干条首尾相接的记录和（第 2 版起）末尾的索引组成，所有整数均为小端序：
+//   文件头  magic "MY2048RC"(8) | 格式版本 u32
+//   记录头  棋盘边长 u8 | GameVersion u8 | flags u8 | 最大指数 u8 | 种子 u64 | 得分 u32 | 步数 u32
+//   记录体  每步一个字节的方向（Direction 的取值）；
+//           flags 含 FLAG_SPAWNS 时其后是 步数 + 2 个 u16 的生成记录（前两个为开局方块）
+//   索引    第 0、INDEX_INTERVAL、2*INDEX_INTERVAL…条记录的文件偏移 u64[n] | n u64 | 记录区结束偏移 u64 | magic "MY2048IX"(8)
+// 只有种子时按 Rng(种子) 重放即可复现整局，生成记录供不依赖 Rng 的分析使用。
+// 索引由 RecordWriter::close 写出，没有正常关闭的文件和第 1 版文件没有索引，仍可顺序读取
+namespace record {
+
+constexpr std::array<char, 8> FILE_MAGIC = {'M', 'Y', '2', '0', '4', '8', 'R', 'C'};
+constexpr std::uint32_t FORMAT_VERSION = 2;
+constexpr std::size_t FILE_HEADER_SIZE = 12;
+constexpr std::size_t RECORD_HEADER_SIZE = 20;
+
+constexpr std::array<char, 8> INDEX_MAGIC = {'M', 'Y', '2', '0', '4', '8', 'I', 'X'};
+constexpr std::size_t INDEX_TRAILER_SIZE = 24;
+constexpr std::uint64_t INDEX_INTERVAL = 4096;
+
+constexpr std::uint8_t FLAG_SPAWNS = 1;
+
+// 生成记录：低 15 位为格子下标，最高位为 1 表示生成的是 4
+constexpr std::uint16_t SPAWN_FOUR = 0x8000;
+
+struct RecordHeader {
+    int gridSize;
+    GameVersion version;
+    std::uint8_t flags;
+    int maxExponent;
+    std::uint64_t seed;
+    std::uint32_t score;
+    std::uint32_t moveCount;
+};
+
+// 记录体的字节数
+std::size_t bodySize(const RecordHeader& header);
+void encodeHeader(const RecordHeader& header, std::uint8_t* out);
+// 字段不合法时返回 false
+bool decodeHeader(const std::uint8_t* data, RecordHeader& header);
+
+inline std::uint16_t encodeSpawn(int cell, int exponent) {
+    return static_cast<std::uint16_t>(cell | (exponent == 2 ? SPAWN_FOUR : 0));
+}
+
+// 指向一条已编码记录的只读视图，数据来自读取缓冲区或内存映射，不做拷贝
+struct RecordView {
+    RecordHeader header;
+    const std::uint8_t* body;
+
+    bool hasSpawns() const { return (header.flags & FLAG_SPAWNS) != 0; }
+    Direction move(std::uint32_t index) const { return static_cast<Direction>(body[index]); }
+    std::uint16_t spawn(std::uint32_t index) const {
+        const std::uint8_t* p = body + header.moveCount + 2 * index;
+        return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+    }
+};
+
+// 正在进行的一局，结束后交给 RecordWriter
+struct GameRecord {
+    RecordHeader header{};
+    std::vector<std::uint8_t> moves;
+    std::vector<std::uint16_t> spawns;
+
+    void begin(int gridSize, GameVersion version, std::uint64_t seed, bool withSpawns);
+    void addMove(Direction dir) { moves.push_back(static_cast<std::uint8_t>(dir)); }
+    void addSpawn(int cell, int exponent) {
+        if (header.flags & FLAG_SPAWNS) spawns.push_back(encodeSpawn(cell, exponent));
+    }
+    // 填入终局得分和最大指数
+    void finish(const Board& board);
+};
+
+// 缓冲写入：write 只把记录编码进内存缓冲区，缓冲区写满后交给后台线程落盘，
+// 调用方（游戏循环或模拟线程）不会等待磁盘。多个线程可以同时 write
+class RecordWriter {
+public:
+    explicit RecordWriter(const std::string& path, std::size_t bufferSize = std::size_t(1) << 20);
+    ~RecordWriter();
+
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    void write(const GameRecord& record);
+    // 写出剩余数据并结束后台线程；写盘失败时抛出 std::runtime_error
+    void close();
+
+private:
+    std::ofstream file;
+    std::size_t bufferSize;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<std::uint8_t> current;
+    std::deque<std::vector<std::uint8_t>> pending;
+    std::uint64_t flushedBytes; // 已交给后台线程的字节数，即 current 开头的文件偏移
+    std::uint64_t recordCount;
+    std::vector<std::uint64_t> index;
+    bool closing;
+    bool closed;
+    bool failed;
+    std::thread worker;
+
+    void run();
+};
+
+// 顺序读取：只保留一个读取缓冲区，逐条返回记录视图，不把整个文件读进内存
+class RecordReader {
+public:
+    explicit RecordReader(const std::string& path, std::size_t bufferSize = std::size_t(1) << 20);
+
+    // 视图在下一次调用 next 前有效；文件结束时返回 false，记录被截断或损坏时抛出 std::runtime_error
+    bool next(RecordView& view);
+
+private:
+    std::ifstream file;
+    std::vector<std::uint8_t> buffer;
+    std::size_t begin;
+    std::size_t end;
+    std::uint64_t unread; // 记录区中还没读进缓冲区的字节数，不读到末尾的索引
+
+    bool fill(std::size_t needed);
+};
+
+// 检查文件头，返回格式是否匹配（接受第 1 版和当前版本）
+bool checkFileHeader(const std::uint8_t* data, std::size_t size);
+
+// 读取整个文件 data 末尾的索引：找到时返回 true，给出记录区的结束偏移和各索引项；
+// 没有索引时返回 false，记录区延伸到文件末尾
+bool readIndex(const std::uint8_t* data, std::size_t size, std::size_t& recordsEnd, std::vector<std::size_t>& starts);
+
+// 在 board 上重放一条记录，每走一步调用 onMove(board, dir)（此时尚未生成新方块）。
+// 有生成记录时按记录摆放方块，否则用 Rng(种子) 复现。记录与规则不符时返回 false
+template <class OnMove>
+bool replay(const RecordView& view, Board& board, OnMove&& onMove) {
+    const RecordHeader& header = view.header;
+    board = Board(header.gridSize, header.version);
+    Rng rng(header.seed);
+    const bool withSpawns = view.hasSpawns();
+
+    auto spawn = [&](std::uint32_t index) {
+        if (!withSpawns) {
+            board.addRandomTile(rng);
+            return true;
+        }
+        const std::uint16_t encoded = view.spawn(index);
+        const int cell = encoded & ~SPAWN_FOUR;
+        if (cell >= board.getCellCount() || board.getCell(cell) != 0) {
+            return false;
+        }
+        board.setCell(cell, (encoded & SPAWN_FOUR) ? 2 : 1);
+        return true;
+    };
+
+    if (!spawn(0) || !spawn(1)) {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < header.moveCount; ++i) {
+        const Direction dir = view.move(i);
+        if (view.body[i] > static_cast<std::uint8_t>(Direction::DOWN_RIGHT) || !board.move(dir)) {
+            return false;
+        }
+        onMove(board, dir);
+        if (!spawn(i + 2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace record
+
+#endif // GAMERECORD_H
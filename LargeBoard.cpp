@@ -0,0 +1,500 @@
+#include "LargeBoard.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+// 整字比较时第 i 个字节对应第 i 格
+static_assert(std::endian::native == std::endian::little, "LargeBoard assumes a little-endian target");
+
+namespace {
+
+constexpr std::uint64_t LOW7 = 0x7F7F7F7F7F7F7F7FULL;
+constexpr std::uint64_t HIGH = 0x8080808080808080ULL;
+
+std::uint64_t load(const std::uint8_t* p) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// 第 i 位为 1 表示 word 的第 i 个字节为 0
+std::uint64_t zeroBytes(std::uint64_t word) {
+    const std::uint64_t zero = ~(((word & LOW7) + LOW7) | word) & HIGH;
+    return ((zero >> 7) * 0x0102040810204080ULL) >> 56;
+}
+
+void store(std::uint8_t* p, std::uint64_t word) {
+    std::memcpy(p, &word, sizeof(word));
+}
+
+// 8x8 字节块原地转置：第 i 个字的第 j 个字节与第 j 个字的第 i 个字节互换。
+// 依次交换 4x4、2x2、1x1 的子块，每步对成对的字做一次异或交换
+void transpose8(std::array<std::uint64_t, 8>& w) {
+    for (int i = 0; i < 4; ++i) {
+        const std::uint64_t t = ((w[i] >> 32) ^ w[i + 4]) & 0x00000000FFFFFFFFULL;
+        w[i] ^= t << 32;
+        w[i + 4] ^= t;
+    }
+    for (int i : {0, 1, 4, 5}) {
+        const std::uint64_t t = ((w[i] >> 16) ^ w[i + 2]) & 0x0000FFFF0000FFFFULL;
+        w[i] ^= t << 16;
+        w[i + 2] ^= t;
+    }
+    for (int i = 0; i < 8; i += 2) {
+        const std::uint64_t t = ((w[i] >> 8) ^ w[i + 1]) & 0x00FF00FF00FF00FFULL;
+        w[i] ^= t << 8;
+        w[i + 1] ^= t;
+    }
+}
+
+constexpr std::uint64_t LANES = 0x0101010101010101ULL;
+constexpr std::uint64_t EVEN_BITS = 0x5555555555555555ULL;
+
+// 第 i 个字节非零时第 8i 位为 1，其余位为 0
+std::uint64_t nonzeroLanes(std::uint64_t word) {
+    return ((((word & LOW7) + LOW7) | word) & HIGH) >> 7;
+}
+
+// 把 8 位掩码的第 i 位放到第 8i 位
+std::uint64_t spreadLanes(std::uint64_t bits) {
+    bits = (bits | (bits << 28)) & 0x0000000F0000000FULL;
+    bits = (bits | (bits << 14)) & 0x0003000300030003ULL;
+    return (bits | (bits << 7)) & LANES;
+}
+
+// 把 lanes（按 nonzeroLanes 的格式）标出的字节按原顺序挤到低位，高位补 0，即按字节粒度的 compress。
+// shifts 的每个字节是它前面要去掉的字节数（乘以 LANES 求前缀和），按这个数的 1、2、4 位分三轮整体右移，
+// 每轮移动的字节带着自己的 shifts 一起移，先移低位不会相互覆盖
+std::uint64_t compressBytes(std::uint64_t word, std::uint64_t lanes) {
+    const std::uint64_t keep = lanes * 0xFF;
+    word &= keep;
+    std::uint64_t shifts = (((~lanes & LANES) * LANES) << 8) & keep;
+    for (int bit = 0; bit < 3; ++bit) {
+        const std::uint64_t moving = ((shifts >> bit) & LANES) * 0xFF;
+        const int distance = 8 << bit;
+        const std::uint64_t bytes = word & moving;
+        word = (word ^ bytes) | (bytes >> distance);
+        const std::uint64_t counts = shifts & moving;
+        shifts = (shifts ^ counts) | (counts >> distance);
+    }
+    return word;
+}
+
+std::uint64_t reverseBytes(std::uint64_t word) {
+    word = (word >> 32) | (word << 32);
+    word = ((word >> 16) & 0x0000FFFF0000FFFFULL) | ((word & 0x0000FFFF0000FFFFULL) << 16);
+    return ((word >> 8) & 0x00FF00FF00FF00FFULL) | ((word & 0x00FF00FF00FF00FFULL) << 8);
+}
+
+// 把 source 前 bytes 个字节（8 的倍数）里非零且不在 drop 中的字节按原顺序逐字挤到 target 开头，返回个数。
+// 每个字整字写出，后一个字覆盖前一个字补的 0；最后再补 8 个字节的 0，整字读结果末尾时不会读到旧数据
+int packTiles(const std::uint8_t* source, int bytes, std::uint64_t drop, std::uint8_t* target) {
+    int count = 0;
+    for (int k = 0; k < bytes; k += 8) {
+        const std::uint64_t word = load(source + k);
+        const std::uint64_t lanes = nonzeroLanes(word) & ~spreadLanes((drop >> k) & 0xFF);
+        if (lanes == 0) {
+            continue;
+        }
+        store(target + count, lanes == LANES ? word : compressBytes(word, lanes));
+        count += std::popcount(lanes);
+    }
+    store(target + count, 0);
+    return count;
+}
+
+std::uint64_t lowBits(int count) {
+    return count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+}
+
+// 把按离墙由近到远排好的 count 个方块原地合并，返回合并后的方块数
+int mergeTiles(std::uint8_t* values, int count, movetable::MergeRule rule, std::uint64_t& gained) {
+    int out = 0;
+    if (rule == movetable::MergeRule::CHAIN) {
+        for (int i = 0; i < count; ++i) {
+            values[out++] = values[i];
+            while (out >= 2 && values[out - 1] == values[out - 2]) {
+                --out;
+                ++values[out - 1];
+                gained += std::uint64_t(1) << values[out - 1];
+            }
+        }
+        return out;
+    }
+
+    bool lastMerged = false;
+    for (int i = 0; i < count; ++i) {
+        if (out > 0 && !lastMerged && values[out - 1] == values[i]) {
+            ++values[out - 1];
+            gained += std::uint64_t(1) << values[out - 1];
+            lastMerged = true;
+        } else {
+            values[out++] = values[i];
+            lastMerged = false;
+        }
+    }
+    return out;
+}
+
+// 依次对 dir 方向的每条斜线调用 f(起点 x, 起点 y, 长度)，起点紧贴墙，线沿 dir 的反方向延伸；f 返回 true 时停止
+template <typename F>
+bool anyDiagonal(int size, Direction dir, F&& f) {
+    const int dx = directionDx(dir);
+    const int dy = directionDy(dir);
+    const int wallY = dy < 0 ? 0 : size - 1;
+    const int wallX = dx < 0 ? 0 : size - 1;
+    auto visit = [&](int x, int y) {
+        const int length = std::min(dx < 0 ? size - x : x + 1, dy < 0 ? size - y : y + 1);
+        return length >= 2 && f(x, y, length);
+    };
+    for (int x = 0; x < size; ++x) {
+        if (visit(x, wallY)) return true;
+    }
+    for (int y = 0; y < size; ++y) {
+        if (y != wallY && visit(wallX, y)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+LargeBoard::LargeBoard(int size, GameVersion version)
+    : size(size), stride((size + 7) & ~7), version(version), rowMask(lowBits(size)) {
+    if (size < MIN_SIZE || size > MAX_SIZE) {
+        throw std::invalid_argument("Unsupported grid size");
+    }
+    cells.resize(static_cast<std::size_t>(size) * stride + 8);
+    emptyRows.resize(size);
+    reset();
+}
+
+void LargeBoard::reset() {
+    std::fill(cells.begin(), cells.end(), 0);
+    std::fill(emptyRows.begin(), emptyRows.end(), rowMask);
+    emptyCount = size * size;
+    score = 0;
+    won = false;
+}
+
+int LargeBoard::getMaxExponent() const {
+    int result = 0;
+    for (int y = 0; y < size; ++y) {
+        const std::uint8_t* row = &cells[y * stride];
+        result = std::max(result, static_cast<int>(*std::max_element(row, row + size)));
+    }
+    return result;
+}
+
+std::uint64_t LargeBoard::equalRight(int y) const {
+    const std::uint8_t* row = &cells[y * stride];
+    std::uint64_t mask = 0;
+    for (int k = 0; k < stride; k += 8) {
+        mask |= zeroBytes(load(row + k) ^ load(row + k + 1)) << k;
+    }
+    return mask & (rowMask >> 1);
+}
+
+std::uint64_t LargeBoard::equalBelow(int y) const {
+    const std::uint8_t* row = &cells[y * stride];
+    std::uint64_t mask = 0;
+    for (int k = 0; k < stride; k += 8) {
+        mask |= zeroBytes(load(row + k) ^ load(row + stride + k)) << k;
+    }
+    return mask & rowMask;
+}
+
+bool LargeBoard::rowCanMove(int y, bool towardLeft) const {
+    const std::uint64_t empty = emptyRows[y];
+    const std::uint64_t occupied = ~empty & rowMask;
+    if (occupied == 0) {
+        return false;
+    }
+    // 方块的移动方向上紧挨着空格
+    if (towardLeft ? (empty & (occupied >> 1)) != 0 : (occupied & (empty >> 1)) != 0) {
+        return true;
+    }
+    return (equalRight(y) & occupied & (occupied >> 1)) != 0;
+}
+
+std::uint64_t LargeBoard::movableColumns(bool towardTop) const {
+    std::uint64_t columns = 0;
+    for (int y = 0; y + 1 < size; ++y) {
+        const std::uint64_t upper = emptyRows[y];
+        const std::uint64_t lower = emptyRows[y + 1];
+        columns |= towardTop ? (upper & ~lower) : (~upper & lower);
+        // 已经确定能动的列不用再比较数值
+        const std::uint64_t both = ~upper & ~lower & rowMask & ~columns;
+        if (both != 0) {
+            columns |= equalBelow(y) & both;
+        }
+    }
+    return columns & rowMask;
+}
+
+int LargeBoard::slideLine(std::uint8_t* line, bool towardStart, std::uint64_t& gained) const {
+    // 向末尾移动时先把整条线（含补齐的字节）逐字倒过来，按向开头处理，最后再倒回去
+    std::array<std::uint8_t, MAX_SIZE + 8> reversed;
+    const std::uint8_t* source = line;
+    if (!towardStart) {
+        for (int k = 0; k < stride; k += 8) {
+            store(&reversed[stride - 8 - k], reverseBytes(load(line + k)));
+        }
+        source = reversed.data();
+    }
+
+    std::array<std::uint8_t, MAX_SIZE + 8> tiles;
+    std::array<std::uint8_t, MAX_SIZE + 8> packed;
+    const int count = packTiles(source, stride, 0, tiles.data());
+    if (count == 0) {
+        return 0;
+    }
+
+    // 第 i 位为 1 表示压紧后第 i 个和第 i+1 个方块相同
+    std::uint64_t equal = 0;
+    for (int k = 0; k < count; k += 8) {
+        equal |= zeroBytes(load(&tiles[k]) ^ load(&tiles[k + 1])) << k;
+    }
+    equal &= lowBits(count - 1);
+
+    // result 指向合并后的方块，其后至少 8 个字节为 0
+    const std::uint8_t* result = tiles.data();
+    int merged = count;
+    if (equal != 0 && mergeRule(version) == movetable::MergeRule::STANDARD) {
+        // 每段连续相同的方块从头起两两合并：段起点在偶数位的段取偶数位，在奇数位的段取奇数位。
+        // 给偶数位起点加 1，进位会清掉整段，由此分出两类段
+        const std::uint64_t starts = equal & ~(equal << 1);
+        const std::uint64_t evenRuns = equal & ~(equal + (starts & EVEN_BITS));
+        const std::uint64_t merges = (evenRuns & EVEN_BITS) | (equal & ~evenRuns & ~EVEN_BITS);
+        for (std::uint64_t rest = merges; rest != 0; rest &= rest - 1) {
+            gained += std::uint64_t(1) << (tiles[std::countr_zero(rest)] + 1);
+        }
+        for (int k = 0; k < count; k += 8) {
+            store(&tiles[k], load(&tiles[k]) + spreadLanes((merges >> k) & 0xFF));
+        }
+        // 每对的后一个方块并入前一个，去掉后再挤一次
+        merged = packTiles(tiles.data(), (count + 7) & ~7, merges << 1, packed.data());
+        result = packed.data();
+    } else if (equal != 0) {
+        // 连续合并是级联的（合并出的方块还会与前一个合并），只有存在相邻相同方块时才逐个处理
+        merged = mergeTiles(tiles.data(), count, movetable::MergeRule::CHAIN, gained);
+        std::memset(&tiles[merged], 0, count - merged);
+    }
+
+    auto resultWord = [&](int k) { return k < merged ? load(result + k) : 0; };
+    if (towardStart) {
+        for (int k = 0; k < stride; k += 8) {
+            store(line + k, resultWord(k));
+        }
+    } else {
+        // 倒回去后方块靠在补齐区的末尾，错开 stride - size 个字节整字读回，贴到第 size-1 格
+        for (int k = 0; k < stride; k += 8) {
+            store(&reversed[stride - 8 - k], reverseBytes(resultWord(k)));
+        }
+        store(&reversed[stride], 0);
+        for (int k = 0; k < stride; k += 8) {
+            store(line + k, load(&reversed[stride - size + k]));
+        }
+    }
+    return merged;
+}
+
+void LargeBoard::moveRow(int y, bool towardLeft, std::uint64_t& gained) {
+    const std::uint64_t occupied = ~emptyRows[y] & rowMask;
+    const int merged = slideLine(&cells[y * stride], towardLeft, gained);
+    emptyRows[y] = rowMask & ~(towardLeft ? lowBits(merged) : lowBits(merged) << (size - merged));
+    emptyCount += std::popcount(occupied) - merged;
+}
+
+void LargeBoard::moveColumns(std::uint64_t columns, bool towardTop, std::uint64_t& gained) {
+    // 含有能动的列的每一组 8 列按 8x8 字节块整字转置到 lines（第 x 行为第 x 列），
+    // 按连续存放的行处理完再转置回来。lines 在栈上，不分配内存；最后一组行不足 8 行时缺的行按空格处理
+    std::array<std::uint8_t, MAX_SIZE * MAX_SIZE> lines;
+    std::array<std::uint64_t, 8> block;
+    auto transposeGroup = [&](int group, bool toLines) {
+        for (int rowBlock = 0; rowBlock < stride; rowBlock += 8) {
+            const int rows = std::min(8, size - rowBlock);
+            for (int i = 0; i < 8; ++i) {
+                block[i] = toLines ? (i < rows ? load(&cells[(rowBlock + i) * stride + group]) : 0)
+                                   : load(&lines[(group + i) * stride + rowBlock]);
+            }
+            transpose8(block);
+            for (int i = 0; i < 8; ++i) {
+                if (toLines) {
+                    store(&lines[(group + i) * stride + rowBlock], block[i]);
+                } else if (i < rows) {
+                    store(&cells[(rowBlock + i) * stride + group], block[i]);
+                }
+            }
+        }
+    };
+
+    for (int group = 0; group < stride; group += 8) {
+        if ((columns >> group) & 0xFF) transposeGroup(group, true);
+    }
+    for (std::uint64_t rest = columns; rest != 0; rest &= rest - 1) {
+        std::uint8_t* line = &lines[std::countr_zero(rest) * stride];
+        std::uint64_t empty = 0;
+        for (int k = 0; k < stride; k += 8) {
+            empty |= zeroBytes(load(line + k)) << k;
+        }
+        const std::uint64_t occupied = ~empty & rowMask;
+        emptyCount += std::popcount(occupied) - slideLine(line, towardTop, gained);
+    }
+    for (int group = 0; group < stride; group += 8) {
+        if ((columns >> group) & 0xFF) transposeGroup(group, false);
+    }
+
+    // 各行的空格掩码按整字重算
+    for (int y = 0; y < size; ++y) {
+        std::uint64_t empty = 0;
+        for (int k = 0; k < stride; k += 8) {
+            empty |= zeroBytes(load(&cells[y * stride + k])) << k;
+        }
+        emptyRows[y] = empty & rowMask;
+    }
+}
+
+bool LargeBoard::diagonalCanMove(Direction dir) const {
+    const int dx = directionDx(dir);
+    const int dy = directionDy(dir);
+    return anyDiagonal(size, dir, [&](int x, int y, int length) {
+        // 方块前面有空格，或者（方块都已靠墙时）相邻两个方块相同
+        bool gap = false;
+        int previous = 0;
+        for (int i = 0; i < length; ++i) {
+            const int exponent = getExponent(x - dx * i, y - dy * i);
+            if (exponent == 0) {
+                gap = true;
+            } else if (gap || exponent == previous) {
+                return true;
+            }
+            previous = exponent;
+        }
+        return false;
+    });
+}
+
+bool LargeBoard::moveDiagonals(Direction dir, std::uint64_t& gained) {
+    const int dx = directionDx(dir);
+    const int dy = directionDy(dir);
+    const movetable::MergeRule rule = mergeRule(version);
+    bool moved = false;
+    anyDiagonal(size, dir, [&](int x, int y, int length) {
+        std::array<std::uint8_t, MAX_SIZE> values;
+        int count = 0;
+        for (int i = 0; i < length; ++i) {
+            const int exponent = getExponent(x - dx * i, y - dy * i);
+            if (exponent != 0) values[count++] = static_cast<std::uint8_t>(exponent);
+        }
+        const int merged = mergeTiles(values.data(), count, rule, gained);
+        for (int i = 0; i < length; ++i) {
+            const int exponent = i < merged ? values[i] : 0;
+            if (getExponent(x - dx * i, y - dy * i) != exponent) {
+                writeCell(x - dx * i, y - dy * i, exponent);
+                moved = true;
+            }
+        }
+        return false;
+    });
+    return moved;
+}
+
+bool LargeBoard::canMove(Direction dir) const {
+    switch (dir) {
+        case Direction::LEFT:
+        case Direction::RIGHT:
+            for (int y = 0; y < size; ++y) {
+                if (rowCanMove(y, dir == Direction::LEFT)) return true;
+            }
+            return false;
+        case Direction::UP:
+        case Direction::DOWN:
+            return movableColumns(dir == Direction::UP) != 0;
+        default:
+            return diagonalCanMove(dir);
+    }
+}
+
+bool LargeBoard::move(Direction dir) {
+    std::uint64_t gained = 0;
+    bool moved = false;
+    switch (dir) {
+        case Direction::LEFT:
+        case Direction::RIGHT:
+            // 只重写能动的行
+            for (int y = 0; y < size; ++y) {
+                if (rowCanMove(y, dir == Direction::LEFT)) {
+                    moveRow(y, dir == Direction::LEFT, gained);
+                    moved = true;
+                }
+            }
+            break;
+        case Direction::UP:
+        case Direction::DOWN: {
+            const std::uint64_t columns = movableColumns(dir == Direction::UP);
+            if (columns != 0) {
+                moveColumns(columns, dir == Direction::UP, gained);
+                moved = true;
+            }
+            break;
+        }
+        default:
+            moved = moveDiagonals(dir, gained);
+            break;
+    }
+    score += gained;
+    updateWon(gained);
+    return moved;
+}
+
+int LargeBoard::addRandomTile(Rng& rng) {
+    if (emptyCount == 0) {
+        return -1;
+    }
+
+    // 与 Board 相同：按行优先顺序取第 k 个空格，先按行跳过，再在行掩码里取第 k 个为 1 的位
+    std::uint32_t k = rng.nextBelow(static_cast<std::uint32_t>(emptyCount));
+    int y = 0;
+    for (std::uint32_t rowEmpty; k >= (rowEmpty = static_cast<std::uint32_t>(std::popcount(emptyRows[y]))); ++y) {
+        k -= rowEmpty;
+    }
+    std::uint64_t mask = emptyRows[y];
+    for (; k > 0; --k) {
+        mask &= mask - 1;
+    }
+    const int x = std::countr_zero(mask);
+    writeCell(x, y, rng.nextBelow(10) < 8 ? 1 : 2);
+    return y * size + x;
+}
+
+bool LargeBoard::isGameOver() const {
+    if (version == GameVersion::MODIFIED) {
+        // 与 Board 一致，空棋盘不算结束
+        if (emptyCount == size * size) {
+            return false;
+        }
+        for (Direction dir : getDirections()) {
+            if (diagonalCanMove(dir)) return false;
+        }
+        return true;
+    }
+
+    // 有空格且有方块时总有一行或一列能移动，空棋盘也不算结束；棋盘满时只看相邻的相同方块
+    if (emptyCount != 0) {
+        return false;
+    }
+    for (int y = 0; y < size; ++y) {
+        if (equalRight(y) != 0 || (y + 1 < size && equalBelow(y) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LargeBoard::updateWon(std::uint64_t gained) {
+    // 合成 2048 的那次移动得分至少是 2048，其余情况不用扫描棋盘
+    if (!won && gained >= (std::uint64_t(1) << Board::WIN_EXPONENT)) {
+        won = getMaxExponent() >= Board::WIN_EXPONENT;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef LARGEBOARD_H
+#define LARGEBOARD_H
+
+#include "Board.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// 大棋盘（边长最多 64）的规则实现，供无界面压力测试使用。规则、生成方块的随机数用法和格子编号都与 Board 相同，
+// 同一种子在 4~6 格上的对局与 Board 完全一致。
+// 格子按行优先每格一个字节存指数，每行补齐到 8 字节的整数倍，按 64 位字整行读取；每行的空格用一个 64 位掩码表示。
+// 上下左右能否移动、是否结束都用整字运算判断；移动时只处理会变化的行或列，按字压紧、合并整行，
+// 上下移动先把这些列按 8x8 字节块整字转置成连续的行，与左右移动共用同一套行处理，再转置回去。斜向按线逐格处理
+class LargeBoard {
+public:
+    static constexpr int MIN_SIZE = 2;
+    static constexpr int MAX_SIZE = 64;
+
+    explicit LargeBoard(int size = 16, GameVersion version = GameVersion::ORIGINAL);
+
+    void reset();
+
+    int getSize() const { return size; }
+    GameVersion getVersion() const { return version; }
+    std::uint64_t getScore() const { return score; }
+    bool hasWon() const { return won; }
+
+    int getExponent(int x, int y) const { return cells[y * stride + x]; }
+    int getMaxExponent() const;
+
+    // 按行优先下标（y*size+x）读写指数，与 Board 的编号一致
+    int getCellCount() const { return size * size; }
+    int getCell(int cell) const { return getExponent(cell % size, cell / size); }
+    void setCell(int cell, int exponent) { writeCell(cell % size, cell / size, exponent); }
+
+    int getEmptyCount() const { return emptyCount; }
+    // 第 y 行的空格掩码：第 x 位为 1 表示格子 (x, y) 为空
+    std::uint64_t getEmptyRow(int y) const { return emptyRows[y]; }
+
+    const std::array<Direction, 4>& getDirections() const { return versionDirections(version); }
+
+    bool move(Direction dir);
+    bool canMove(Direction dir) const;
+
+    // 在随机空格生成一个新方块（80% 为 2，20% 为 4），返回格子下标，没有空格时返回 -1
+    int addRandomTile(Rng& rng);
+
+    bool isGameOver() const;
+
+private:
+    int size;
+    int stride; // 每行占的字节数：size 向上取整到 8 的倍数
+    GameVersion version;
+    std::uint64_t rowMask; // 低 size 位为 1
+    std::vector<std::uint8_t> cells; // size 行，每行 stride 字节，末尾多留 8 字节，错开一格整字读取时不越界
+    std::vector<std::uint64_t> emptyRows;
+    int emptyCount;
+    std::uint64_t score;
+    bool won;
+
+    void writeCell(int x, int y, int exponent) {
+        cells[y * stride + x] = static_cast<std::uint8_t>(exponent);
+        const std::uint64_t bit = std::uint64_t(1) << x;
+        const bool wasEmpty = (emptyRows[y] & bit) != 0;
+        emptyRows[y] = exponent == 0 ? (emptyRows[y] | bit) : (emptyRows[y] & ~bit);
+        emptyCount += (exponent == 0) - wasEmpty;
+    }
+
+    // 第 x 位为 1 表示 (x, y) 与右边 / 下边的格子指数相同（包括两个都为空）
+    std::uint64_t equalRight(int y) const;
+    std::uint64_t equalBelow(int y) const;
+
+    // 第 y 行向左 / 向右能移动
+    bool rowCanMove(int y, bool towardLeft) const;
+    // 向上 / 向下能移动的列的掩码
+    std::uint64_t movableColumns(bool towardTop) const;
+
+    // 把连续存放的一条线向开头或末尾合并、写回，返回剩下的方块数。逐字压紧、找相邻相同的方块，
+    // 原版规则的合并也按字完成；连续合并只在有相邻相同方块时逐个处理
+    int slideLine(std::uint8_t* line, bool towardStart, std::uint64_t& gained) const;
+    void moveRow(int y, bool towardLeft, std::uint64_t& gained);
+    void moveColumns(std::uint64_t columns, bool towardTop, std::uint64_t& gained);
+    // 斜向逐线处理
+    bool moveDiagonals(Direction dir, std::uint64_t& gained);
+    bool diagonalCanMove(Direction dir) const;
+    void updateWon(std::uint64_t gained);
+};
+
+#endif // LARGEBOARD_H
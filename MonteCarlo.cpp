@@ -0,0 +1,315 @@
+#include "MonteCarlo.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <new>
+
+namespace {
+
+// 每批同步前进的 rollout 数，也是线程领取任务的单位
+constexpr int ROLLOUT_BATCH = 32;
+// 每个线程 arena 的大小，一批 rollout 的状态约 2KB
+constexpr std::size_t ARENA_SIZE = 64 * 1024;
+
+// 线程私有的线性分配器：创建线程时一次性申请，每批 rollout 前 reset，分配只移动偏移量
+class Arena {
+public:
+    explicit Arena(std::size_t capacity) : buffer(new std::byte[capacity]), capacity(capacity), used(0) {}
+
+    template <class T>
+    T* allocate(std::size_t count) {
+        const std::size_t offset = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (offset + sizeof(T) * count > capacity) {
+            throw std::bad_alloc();
+        }
+        used = offset + sizeof(T) * count;
+        return reinterpret_cast<T*>(buffer.get() + offset);
+    }
+
+    void reset() { used = 0; }
+
+private:
+    std::unique_ptr<std::byte[]> buffer;
+    std::size_t capacity;
+    std::size_t used;
+};
+
+// 与 Board::addRandomTile 相同的分布
+Bitboard spawnPacked(Bitboard board, Rng& rng) {
+    std::uint16_t mask = bitboard::emptyMask(board);
+    if (mask == 0) {
+        return board;
+    }
+    for (std::uint32_t k = rng.nextBelow(static_cast<std::uint32_t>(std::popcount(mask))); k > 0; --k) {
+        mask &= mask - 1;
+    }
+    const Bitboard exponent = rng.nextBelow(10) < 8 ? 1 : 2;
+    return board | (exponent << (4 * std::countr_zero(mask)));
+}
+
+// 在一个棋盘的四个方向结果里按策略选一个，都不能走时返回 -1
+int choosePacked(RolloutPolicy policy, const std::array<std::uint8_t*, 4>& moved,
+                 const std::array<std::uint32_t*, 4>& gained, int i, Rng& rng) {
+    if (policy == RolloutPolicy::RANDOM) {
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+            count += moved[d][i];
+        }
+        if (count == 0) {
+            return -1;
+        }
+        std::uint32_t k = rng.nextBelow(static_cast<std::uint32_t>(count));
+        for (int d = 0; d < 4; ++d) {
+            if (moved[d][i] && k-- == 0) {
+                return d;
+            }
+        }
+    }
+
+    // 得分相同时从随机的起点开始比较，避免总偏向同一个方向
+    const int offset = static_cast<int>(rng.nextBelow(4));
+    int best = -1;
+    for (int j = 0; j < 4; ++j) {
+        const int d = (offset + j) & 3;
+        if (moved[d][i] && (best < 0 || gained[d][i] > gained[best][i])) {
+            best = d;
+        }
+    }
+    return best;
+}
+
+// 4x4 原版：count 个 rollout 同步前进，每一步用 moveBatch 一次算出所有棋盘四个方向的结果，
+// 结束的 rollout 从数组中移除，剩下的保持连续。返回各 rollout 得分之和（两个 32768 不合并，与 bitboard 一致）
+double rolloutPacked(Bitboard start, int count, RolloutPolicy policy, Arena& arena, Rng& rng) {
+    Bitboard* boards = arena.allocate<Bitboard>(count);
+    std::uint64_t* scores = arena.allocate<std::uint64_t>(count);
+    std::array<Bitboard*, 4> results;
+    std::array<std::uint32_t*, 4> gained;
+    std::array<std::uint8_t*, 4> moved;
+    for (int d = 0; d < 4; ++d) {
+        results[d] = arena.allocate<Bitboard>(count);
+        gained[d] = arena.allocate<std::uint32_t>(count);
+        moved[d] = arena.allocate<std::uint8_t>(count);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        boards[i] = spawnPacked(start, rng);
+        scores[i] = 0;
+    }
+
+    double total = 0.0;
+    int alive = count;
+    while (alive > 0) {
+        for (int d = 0; d < 4; ++d) {
+            bitboard::moveBatch(boards, alive, static_cast<Direction>(d), results[d], gained[d], moved[d]);
+        }
+        int kept = 0;
+        for (int i = 0; i < alive; ++i) {
+            const int d = choosePacked(policy, moved, gained, i, rng);
+            if (d < 0) {
+                total += static_cast<double>(scores[i]);
+                continue;
+            }
+            boards[kept] = spawnPacked(results[d][i], rng);
+            scores[kept] = scores[i] + gained[d][i];
+            ++kept;
+        }
+        alive = kept;
+    }
+    return total;
+}
+
+// 按策略走一步，不能走时返回 false
+bool stepBoard(Board& board, RolloutPolicy policy, Rng& rng) {
+    const std::array<Direction, 4>& directions = board.getDirections();
+    if (policy == RolloutPolicy::RANDOM) {
+        // 随机排列中第一个能走的方向，在能走的方向里均匀分布
+        std::array<Direction, 4> order = directions;
+        for (int i = 3; i > 0; --i) {
+            std::swap(order[i], order[rng.nextBelow(static_cast<std::uint32_t>(i + 1))]);
+        }
+        for (Direction dir : order) {
+            if (board.move(dir)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const int offset = static_cast<int>(rng.nextBelow(4));
+    Board best;
+    int bestGain = -1;
+    for (int j = 0; j < 4; ++j) {
+        Board child = board;
+        if (child.move(directions[(offset + j) & 3]) && child.getScore() - board.getScore() > bestGain) {
+            bestGain = child.getScore() - board.getScore();
+            best = child;
+        }
+    }
+    if (bestGain < 0) {
+        return false;
+    }
+    board = best;
+    return true;
+}
+
+// 其他尺寸和修改版：逐个 rollout，棋盘都在栈上
+double rolloutBoards(const Board& start, int count, RolloutPolicy policy, Rng& rng) {
+    double total = 0.0;
+    for (int i = 0; i < count; ++i) {
+        Board board = start;
+        board.addRandomTile(rng);
+        while (stepBoard(board, policy, rng)) {
+            board.addRandomTile(rng);
+        }
+        total += board.getScore() - start.getScore();
+    }
+    return total;
+}
+
+} // namespace
+
+struct alignas(64) MonteCarloPlayer::Worker {
+    Arena arena{ARENA_SIZE};
+    Rng rng;
+    std::array<double, 4> totals{};
+    std::array<std::uint64_t, 4> counts{};
+};
+
+MonteCarloPlayer::MonteCarloPlayer(const MonteCarloOptions& options)
+    : options(options), seed(options.seed), generation(0), running(0), stopping(false), nextChunk(0),
+      lastRollouts(0) {
+    this->options.rolloutsPerMove = std::max(1, options.rolloutsPerMove);
+    const int threadCount = options.threads > 0 ? options.threads
+                                                : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // 调用 chooseMove 的线程充当第 0 个工作线程
+    for (int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(&MonteCarloPlayer::workerLoop, this, i);
+    }
+}
+
+MonteCarloPlayer::~MonteCarloPlayer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void MonteCarloPlayer::reseed(std::uint64_t newSeed) {
+    seed = newSeed;
+}
+
+bool MonteCarloPlayer::chooseMove(const Board& board, Direction& best) {
+    std::array<Direction, 4> candidates;
+    task.candidateCount = 0;
+    for (Direction dir : board.getDirections()) {
+        Board after = board;
+        if (after.move(dir)) {
+            candidates[task.candidateCount] = dir;
+            task.afterstates[task.candidateCount] = after;
+            ++task.candidateCount;
+        }
+    }
+    lastRollouts = 0;
+    if (task.candidateCount == 0) {
+        return false;
+    }
+    if (task.candidateCount == 1) {
+        best = candidates[0];
+        return true;
+    }
+
+    task.packedRollouts = board.getSize() == 4 && board.getVersion() == GameVersion::ORIGINAL;
+    for (int c = 0; c < task.candidateCount && task.packedRollouts; ++c) {
+        task.packedRollouts = task.afterstates[c].toBitboard(task.packed[c]);
+    }
+    // 第 k 块属于第 k % candidateCount 个方向，提前停下时各方向的 rollout 数最多差一块
+    task.chunksPerCandidate = (options.rolloutsPerMove + ROLLOUT_BATCH - 1) / ROLLOUT_BATCH;
+    task.chunkCount = task.chunksPerCandidate * task.candidateCount;
+    task.useDeadline = options.timeBudget.count() > 0;
+    task.deadline = std::chrono::steady_clock::now() + options.timeBudget;
+
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        workers[i]->rng = Rng(Rng::streamSeed(seed, i));
+        workers[i]->totals.fill(0.0);
+        workers[i]->counts.fill(0);
+    }
+    seed = Rng::streamSeed(seed, workers.size());
+    nextChunk.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++generation;
+        running = static_cast<int>(threads.size());
+    }
+    wake.notify_all();
+    runChunks(*workers[0]);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return running == 0; });
+    }
+
+    double bestValue = -std::numeric_limits<double>::infinity();
+    for (int c = 0; c < task.candidateCount; ++c) {
+        double total = 0.0;
+        std::uint64_t count = 0;
+        for (const auto& worker : workers) {
+            total += worker->totals[c];
+            count += worker->counts[c];
+        }
+        lastRollouts += count;
+        const double value = (task.afterstates[c].getScore() - board.getScore())
+                           + (count > 0 ? total / static_cast<double>(count) : 0.0);
+        if (value > bestValue) {
+            bestValue = value;
+            best = candidates[c];
+        }
+    }
+    return true;
+}
+
+void MonteCarloPlayer::workerLoop(int self) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        runChunks(*workers[self]);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) {
+                done.notify_one();
+            }
+        }
+    }
+}
+
+void MonteCarloPlayer::runChunks(Worker& worker) {
+    for (int chunk = nextChunk.fetch_add(1); chunk < task.chunkCount; chunk = nextChunk.fetch_add(1)) {
+        // 每个方向至少做完一块
+        if (task.useDeadline && chunk >= task.candidateCount && std::chrono::steady_clock::now() >= task.deadline) {
+            return;
+        }
+        const int candidate = chunk % task.candidateCount;
+        const int round = chunk / task.candidateCount;
+        const int count = std::min(ROLLOUT_BATCH, options.rolloutsPerMove - round * ROLLOUT_BATCH);
+
+        worker.arena.reset();
+        worker.totals[candidate] += task.packedRollouts
+            ? rolloutPacked(task.packed[candidate], count, options.policy, worker.arena, worker.rng)
+            : rolloutBoards(task.afterstates[candidate], count, options.policy, worker.rng);
+        worker.counts[candidate] += count;
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include "Board.h"
+#include "Rng.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// rollout 中每一步怎么走：随机选一个能走的方向，或选立即得分最高的方向
+enum class RolloutPolicy {
+    RANDOM,
+    GREEDY
+};
+
+struct MonteCarloOptions {
+    int rolloutsPerMove = 100;               // 每个候选方向的 rollout 次数
+    std::chrono::microseconds timeBudget{0}; // 大于 0 时到时间就停，已完成的 rollout 照常计入
+    int threads = 1;                         // 0 表示使用全部硬件线程
+    RolloutPolicy policy = RolloutPolicy::RANDOM;
+    std::uint64_t seed = 0;
+};
+
+// 蒙特卡洛自动玩家：对每个能走的方向，从移动后的局面出发用 rollout 策略下到终局，
+// 选择 本步得分 + rollout 平均得分 最高的方向。不依赖估值函数，原版和修改版通用。
+// rollout 按批分给常驻的线程池，每个线程在自己的 arena 里放 rollout 状态，热循环中不分配内存；
+// 4x4 原版用 bitboard::moveBatch 让一批 rollout 同步前进
+class MonteCarloPlayer {
+public:
+    explicit MonteCarloPlayer(const MonteCarloOptions& options = MonteCarloOptions());
+    ~MonteCarloPlayer();
+
+    MonteCarloPlayer(const MonteCarloPlayer&) = delete;
+    MonteCarloPlayer& operator=(const MonteCarloPlayer&) = delete;
+
+    // 为当前棋盘选择方向；没有可走的方向时返回 false
+    bool chooseMove(const Board& board, Direction& best);
+    // 之后各线程的 rollout 随机数由 seed 派生，单线程且不限时的结果完全由种子决定
+    void reseed(std::uint64_t seed);
+
+    std::uint64_t getLastRollouts() const { return lastRollouts; }
+
+private:
+    struct Worker;
+
+    // 一次 chooseMove 的共享状态，工作线程只读
+    struct Task {
+        int candidateCount;
+        std::array<Board, 4> afterstates;
+        std::array<Bitboard, 4> packed; // packedRollouts 为真时有效
+        bool packedRollouts;
+        int chunksPerCandidate;
+        int chunkCount;
+        std::chrono::steady_clock::time_point deadline;
+        bool useDeadline;
+    };
+
+    MonteCarloOptions options;
+    std::uint64_t seed;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::uint64_t generation; // 每发布一个任务加一
+    int running;              // 还没做完当前任务的工作线程数
+    bool stopping;
+
+    Task task;
+    std::atomic<int> nextChunk;
+    std::uint64_t lastRollouts;
+
+    void workerLoop(int self);
+    void runChunks(Worker& worker);
+};
+
+#endif // MONTECARLO_H
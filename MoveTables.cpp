@@ -0,0 +1,213 @@
+#include "MoveTables.h"
+#include <bit>
+#include <stdexcept>
+
+namespace movetable {
+
+namespace {
+
+constexpr std::uint32_t LINE_MASK = 0x00FFFFFF;
+constexpr int MERGE_SHIFT = 24;
+constexpr std::uint32_t RIGHT_MOVED = 1u << 30;
+constexpr std::uint32_t LEFT_MOVED = 1u << 31;
+
+// 左移的中间状态：已处理前缀得到的结果行与合并掩码（entry 的低 30 位）、结果中的方块数，以及得分 / 4
+struct SlideState {
+    std::uint32_t entry;
+    int count;
+    std::uint32_t score;
+};
+
+int cellAt(std::uint32_t entry, int i) {
+    return static_cast<int>((entry >> (4 * i)) & 0xF);
+}
+
+// 按原版规则向左滑动时再处理一格：与前一个未合并过的相同方块合并，否则紧贴着放下
+SlideState append(SlideState state, int exponent) {
+    if (exponent == 0) {
+        return state;
+    }
+    if (state.count > 0) {
+        int last = state.count - 1;
+        bool lastMerged = (state.entry >> (MERGE_SHIFT + last)) & 1;
+        if (!lastMerged && exponent < bitboard::MAX_EXPONENT
+            && static_cast<int>((state.entry >> (4 * last)) & 0xF) == exponent) {
+            state.entry += 1u << (4 * last);
+            state.entry |= 1u << (MERGE_SHIFT + last);
+            state.score += 1u << (exponent - 1);
+            return state;
+        }
+    }
+    state.entry |= static_cast<std::uint32_t>(exponent) << (4 * state.count);
+    ++state.count;
+    return state;
+}
+
+// 按连续合并规则再处理一格：放下后只要最后两格相同就继续合并，合并出的格子可以再次合并
+SlideState appendChain(SlideState state, int exponent) {
+    if (exponent == 0) {
+        return state;
+    }
+    state.entry |= static_cast<std::uint32_t>(exponent) << (4 * state.count);
+    ++state.count;
+    while (state.count >= 2) {
+        const int last = state.count - 1;
+        const int value = cellAt(state.entry, last);
+        if (value >= bitboard::MAX_EXPONENT || cellAt(state.entry, last - 1) != value) {
+            break;
+        }
+        // 最后一格并入前一格，清掉它的数值和合并标记
+        state.entry &= ~((0xFu << (4 * last)) | (1u << (MERGE_SHIFT + last)));
+        state.entry += 1u << (4 * (last - 1));
+        state.entry |= 1u << (MERGE_SHIFT + last - 1);
+        state.score += 1u << (value - 1);
+        --state.count;
+    }
+    return state;
+}
+
+} // namespace
+
+LineTable::LineTable(int length, MergeRule rule) : length(length), rule(rule) {
+    if (!supports(length)) {
+        throw std::invalid_argument("Unsupported line length");
+    }
+    const auto step = rule == MergeRule::CHAIN ? appendChain : append;
+
+    // 逐格追加：长度 k 的前缀状态由长度 k-1 的前缀再追加一格得到，避免对每一行重新模拟
+    std::vector<SlideState> prefixes = {SlideState{0, 0, 0}};
+    for (int k = 0; k < length - 1; ++k) {
+        std::vector<SlideState> next(prefixes.size() * 16);
+        for (int exponent = 0; exponent < 16; ++exponent) {
+            std::size_t base = static_cast<std::size_t>(exponent) << (4 * k);
+            for (std::size_t prefix = 0; prefix < prefixes.size(); ++prefix) {
+                next[base | prefix] = step(prefixes[prefix], exponent);
+            }
+        }
+        prefixes.swap(next);
+    }
+
+    const std::size_t count = std::size_t(1) << (4 * length);
+    const unsigned fullMask = (1u << length) - 1;
+    entries.resize(count);
+    if (rule == MergeRule::CHAIN) {
+        scores.resize(count);
+    }
+    for (int exponent = 0; exponent < 16; ++exponent) {
+        std::size_t base = static_cast<std::size_t>(exponent) << (4 * (length - 1));
+        for (std::size_t prefix = 0; prefix < prefixes.size(); ++prefix) {
+            const Line line = static_cast<Line>(base | prefix);
+            const SlideState state = step(prefixes[prefix], exponent);
+            std::uint32_t entry = state.entry;
+            if ((entry & LINE_MASK) != line) {
+                entry |= LEFT_MOVED;
+            }
+
+            // 右移能改变该行：有可合并的一对（与左移相同），或者方块没有全部靠在右侧
+            unsigned occupied = 0;
+            for (int i = 0; i < length; ++i) {
+                if ((line >> (4 * i)) & 0xF) {
+                    occupied |= 1u << i;
+                }
+            }
+            unsigned packedRight = fullMask & ~((1u << (length - std::popcount(occupied))) - 1);
+            if (((entry >> MERGE_SHIFT) & 0x3F) != 0 || occupied != packedRight) {
+                entry |= RIGHT_MOVED;
+            }
+            entries[line] = entry;
+            if (rule == MergeRule::CHAIN) {
+                scores[line] = static_cast<std::uint16_t>(state.score);
+            }
+        }
+    }
+}
+
+LineMove LineTable::decode(Line line) const {
+    const std::uint32_t entry = entries[line];
+    LineMove move;
+    move.line = entry & LINE_MASK;
+    move.mergeMask = static_cast<std::uint8_t>((entry >> MERGE_SHIFT) & 0x3F);
+    move.moved = (entry & LEFT_MOVED) != 0;
+    if (rule == MergeRule::CHAIN) {
+        move.score = 4 * scores[line];
+        return move;
+    }
+    move.score = 0;
+    for (std::uint8_t mask = move.mergeMask; mask != 0; mask &= mask - 1) {
+        int i = std::countr_zero(mask);
+        move.score += 1 << ((move.line >> (4 * i)) & 0xF);
+    }
+    return move;
+}
+
+LineMove LineTable::left(Line line) const {
+    return decode(line);
+}
+
+LineMove LineTable::right(Line line) const {
+    LineMove move = decode(reverse(line, length));
+    move.line = reverse(move.line, length);
+
+    std::uint8_t mask = 0;
+    for (int i = 0; i < length; ++i) {
+        if (move.mergeMask & (1u << i)) {
+            mask |= static_cast<std::uint8_t>(1u << (length - 1 - i));
+        }
+    }
+    move.mergeMask = mask;
+    return move;
+}
+
+const LineTable& table(int length, MergeRule rule) {
+    if (rule == MergeRule::CHAIN) {
+        switch (length) {
+            case 4: { static const LineTable chain4(4, MergeRule::CHAIN); return chain4; }
+            case 5: { static const LineTable chain5(5, MergeRule::CHAIN); return chain5; }
+            case 6: { static const LineTable chain6(6, MergeRule::CHAIN); return chain6; }
+            default: throw std::invalid_argument("Unsupported line length");
+        }
+    }
+    switch (length) {
+        case 4: { static const LineTable table4(4); return table4; }
+        case 5: { static const LineTable table5(5); return table5; }
+        case 6: { static const LineTable table6(6); return table6; }
+        default: throw std::invalid_argument("Unsupported line length");
+    }
+}
+
+const LineLayout& layout(int size, Direction dir) {
+    switch (size) {
+        case 4: return LAYOUTS<4>[static_cast<int>(dir)];
+        case 5: return LAYOUTS<5>[static_cast<int>(dir)];
+        case 6: return LAYOUTS<6>[static_cast<int>(dir)];
+        default: throw std::invalid_argument("Unsupported grid size");
+    }
+}
+
+Line reverse(Line line, int length) {
+    Line result = 0;
+    for (int i = 0; i < length; ++i) {
+        result |= ((line >> (4 * i)) & 0xF) << (4 * (length - 1 - i));
+    }
+    return result;
+}
+
+void slideTargets(Line source, std::uint8_t mergeMask, int length,
+                  std::array<int, MAX_LENGTH>& targets) {
+    int out = 0;
+    bool pending = false; // 当前合并格已经收到了第一个方块
+    for (int i = 0; i < length; ++i) {
+        targets[i] = i;
+        if (((source >> (4 * i)) & 0xF) == 0) continue;
+
+        targets[i] = out;
+        if ((mergeMask & (1u << out)) && !pending) {
+            pending = true;
+        } else {
+            pending = false;
+            ++out;
+        }
+    }
+}
+
+} // namespace movetable
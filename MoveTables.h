@@ -0,0 +1,126 @@
+#ifndef MOVETABLES_H
+#define MOVETABLES_H
+
+#include "Bitboard.h"
+#include "Direction.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace movetable {
+
+// 菜单可选的网格大小
+constexpr int MIN_LENGTH = 4;
+constexpr int MAX_LENGTH = 6;
+// 斜向时一个方向上最多有 2*size-1 条线
+constexpr int MAX_LINES = 2 * MAX_LENGTH - 1;
+
+// 合并规则：原版每个方块每次最多合并一次；连续合并时合并出的方块还能接着与相邻的相同方块合并，
+// 直到这条线上没有可合并的相邻方块（2 2 4 左移得 8）
+enum class MergeRule {
+    STANDARD,
+    CHAIN
+};
+
+// 一行（或一列）方块的压缩表示：第 i 格的指数放在第 4*i 位起的 nibble，与 Bitboard 的行布局一致
+using Line = std::uint32_t;
+
+struct LineMove {
+    Line line;              // 移动后的行
+    int score;              // 合并得到的分数
+    std::uint8_t mergeMask; // 结果中哪些格子由合并得到（第 i 位对应第 i 格）
+    bool moved;
+};
+
+// 某一长度、某一规则下所有行状态的预计算结果。每项 32 位：
+// 低 24 位为左移结果，24-29 位为合并掩码，30 位表示右移会改变该行，31 位表示左移会改变该行。
+// 连续合并时一格可能合并多次，得分不能由结果推出，另存一张得分表
+class LineTable {
+public:
+    explicit LineTable(int length, MergeRule rule = MergeRule::STANDARD);
+
+    int getLength() const { return length; }
+    MergeRule getRule() const { return rule; }
+    LineMove left(Line line) const;
+    LineMove right(Line line) const;
+
+    // 这一行向左或向右至少有一个方向能移动（两种规则下相同：有空隙或相邻相同的方块）
+    bool canMove(Line line) const { return (entries[line] >> 30) != 0; }
+
+private:
+    int length;
+    MergeRule rule;
+    std::vector<std::uint32_t> entries;
+    std::vector<std::uint16_t> scores; // 连续合并的得分 / 4，原版不用
+
+    LineMove decode(Line line) const;
+};
+
+inline bool supports(int length) {
+    return length >= MIN_LENGTH && length <= MAX_LENGTH;
+}
+
+// 首次使用时生成对应长度、规则的表（6 格原版约 64MB，连续合并约 96MB），之后只读，可多线程共享
+const LineTable& table(int length, MergeRule rule = MergeRule::STANDARD);
+
+Line reverse(Line line, int length);
+
+// 某个方向上所有能滑动的线。每条线按离墙由近到远列出格子（下标 y*size+x），
+// 这样任何方向都只需要查左移表；斜向上短于 size 的线在末尾补空格，不影响左移结果。
+// 只有一个格子的线（斜向的两个角）永远不会移动，不会列出
+struct LineLayout {
+    int count;
+    std::array<int, MAX_LINES> lengths;
+    std::array<std::array<std::uint8_t, MAX_LENGTH>, MAX_LINES> cells;
+    std::array<std::uint64_t, MAX_LINES> masks; // 每条线覆盖的格子位掩码
+};
+
+// 编译期生成 size 边长、dir 方向的布局：再往前一步就出界的格子是线的起点（紧贴墙），沿反方向走到出界为止
+constexpr LineLayout makeLayout(int size, Direction dir) {
+    const int dx = directionDx(dir);
+    const int dy = directionDy(dir);
+    LineLayout result{};
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            int nextX = x + dx;
+            int nextY = y + dy;
+            if (nextX >= 0 && nextX < size && nextY >= 0 && nextY < size) continue;
+
+            int length = 0;
+            std::array<std::uint8_t, MAX_LENGTH> cells{};
+            std::uint64_t mask = 0;
+            for (int cx = x, cy = y; cx >= 0 && cx < size && cy >= 0 && cy < size; cx -= dx, cy -= dy) {
+                cells[length++] = static_cast<std::uint8_t>(cy * size + cx);
+                mask |= std::uint64_t(1) << (cy * size + cx);
+            }
+            if (length < 2) continue;
+
+            result.lengths[result.count] = length;
+            result.cells[result.count] = cells;
+            result.masks[result.count] = mask;
+            ++result.count;
+        }
+    }
+    return result;
+}
+
+// 某一边长的 8 个方向的布局，按 Direction 的取值排列，供按边长特化的代码在编译期使用
+template <int Size>
+inline constexpr std::array<LineLayout, 8> LAYOUTS = [] {
+    std::array<LineLayout, 8> all{};
+    for (int d = 0; d < 8; ++d) {
+        all[d] = makeLayout(Size, static_cast<Direction>(d));
+    }
+    return all;
+}();
+
+const LineLayout& layout(int size, Direction dir);
+
+// 由左移前的行和合并掩码推出每个格子上的方块滑到了哪一格；空格保持原下标
+void slideTargets(Line source, std::uint8_t mergeMask, int length,
+                  std::array<int, MAX_LENGTH>& targets);
+
+} // namespace movetable
+
+#endif // MOVETABLES_H
@@ -0,0 +1,237 @@
+#include "NTuple.h"
+#include "Rng.h"
+#include "Symmetry.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::array<char, 8> WEIGHT_MAGIC = {'M', 'Y', '2', '0', '4', '8', 'N', 'T'};
+constexpr std::uint32_t WEIGHT_FORMAT_VERSION = 1;
+constexpr std::size_t WEIGHT_HEADER_SIZE = 32;
+
+using Shape = std::vector<std::pair<int, int>>;
+
+// 棋盘上放置好的各个 tuple（格子坐标）。4x4 用常见的四个 6-tuple：一整行加下一行两格、2x3 方块，
+// 各放在边上和第二行；更大的棋盘把 4 格直线和 2x2 方块平移到所有位置，权重表小得多
+std::vector<Shape> placementsFor(int gridSize) {
+    if (gridSize == 4) {
+        return {
+            {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {0, 1}, {1, 1}},
+            {{0, 1}, {1, 1}, {2, 1}, {3, 1}, {0, 2}, {1, 2}},
+            {{0, 0}, {1, 0}, {2, 0}, {0, 1}, {1, 1}, {2, 1}},
+            {{0, 1}, {1, 1}, {2, 1}, {0, 2}, {1, 2}, {2, 2}},
+        };
+    }
+
+    const std::vector<Shape> shapes = {
+        {{0, 0}, {1, 0}, {2, 0}, {3, 0}},
+        {{0, 0}, {1, 0}, {0, 1}, {1, 1}},
+    };
+    std::vector<Shape> placements;
+    for (const Shape& shape : shapes) {
+        for (int ty = 0; ty < gridSize; ++ty) {
+            for (int tx = 0; tx < gridSize; ++tx) {
+                Shape placed;
+                for (auto [x, y] : shape) {
+                    if (tx + x >= gridSize || ty + y >= gridSize) break;
+                    placed.emplace_back(tx + x, ty + y);
+                }
+                if (placed.size() == shape.size()) {
+                    placements.push_back(std::move(placed));
+                }
+            }
+        }
+    }
+    return placements;
+}
+
+} // namespace
+
+NTupleNetwork::NTupleNetwork(int gridSize)
+    : gridSize(gridSize), weightCount(0), featureCount(0), weights(nullptr) {
+    buildTuples();
+    ownedWeights.assign(weightCount, 0.0f);
+    weights = ownedWeights.data();
+}
+
+NTupleNetwork::NTupleNetwork(int gridSize, const std::string& weightsPath)
+    : gridSize(gridSize), weightCount(0), featureCount(0), weights(nullptr) {
+    buildTuples();
+
+    auto mapped = std::make_unique<MappedFile>(weightsPath);
+    const std::uint8_t* data = mapped->data();
+    if (mapped->size() < WEIGHT_HEADER_SIZE || std::memcmp(data, WEIGHT_MAGIC.data(), WEIGHT_MAGIC.size()) != 0) {
+        throw std::runtime_error("Not a weight file: " + weightsPath);
+    }
+
+    std::uint32_t version;
+    std::uint32_t size;
+    std::uint64_t count;
+    std::memcpy(&version, data + 8, sizeof(version));
+    std::memcpy(&size, data + 12, sizeof(size));
+    std::memcpy(&count, data + 16, sizeof(count));
+    if (version != WEIGHT_FORMAT_VERSION || size != static_cast<std::uint32_t>(gridSize) || count != weightCount
+        || mapped->size() != WEIGHT_HEADER_SIZE + weightCount * sizeof(float)) {
+        throw std::runtime_error("Weight file does not match a " + std::to_string(gridSize) + "x"
+                                 + std::to_string(gridSize) + " network: " + weightsPath);
+    }
+
+    // 文件头 32 字节，映射起点按页对齐，权重可以直接按 float 读取
+    weights = reinterpret_cast<const float*>(data + WEIGHT_HEADER_SIZE);
+    mappedWeights = std::move(mapped);
+}
+
+void NTupleNetwork::buildTuples() {
+    if (!movetable::supports(gridSize)) {
+        throw std::invalid_argument("Unsupported grid size");
+    }
+
+    // 在对称意义下相同的放置共用一张表
+    std::set<std::vector<int>> seen;
+    for (const Shape& placement : placementsFor(gridSize)) {
+        Tuple tuple{weightCount, static_cast<int>(placement.size()), {}};
+        std::vector<int> canonical;
+        for (int s = 0; s < symmetry::COUNT; ++s) {
+            std::array<std::uint8_t, 6> cells{};
+            std::vector<int> sorted;
+            for (std::size_t i = 0; i < placement.size(); ++i) {
+                auto [x, y] = symmetry::transformPoint(s, placement[i].first, placement[i].second, gridSize);
+                cells[i] = static_cast<std::uint8_t>(y * gridSize + x);
+                sorted.push_back(cells[i]);
+            }
+            std::sort(sorted.begin(), sorted.end());
+            if (canonical.empty() || sorted < canonical) canonical = sorted;
+            if (std::find(tuple.instances.begin(), tuple.instances.end(), cells) == tuple.instances.end()) {
+                tuple.instances.push_back(cells);
+            }
+        }
+        if (!seen.insert(canonical).second) continue;
+
+        weightCount += std::size_t(1) << (4 * tuple.length);
+        featureCount += static_cast<int>(tuple.instances.size());
+        tuples.push_back(std::move(tuple));
+    }
+}
+
+float NTupleNetwork::evaluate(const Board& board) const {
+    float total = 0.0f;
+    for (const Tuple& tuple : tuples) {
+        const float* table = weights + tuple.offset;
+        for (const auto& cells : tuple.instances) {
+            std::size_t index = 0;
+            for (int i = 0; i < tuple.length; ++i) {
+                index |= static_cast<std::size_t>(std::min(board.getCell(cells[i]), 15)) << (4 * i);
+            }
+            total += table[index];
+        }
+    }
+    return total;
+}
+
+void NTupleNetwork::update(const Board& board, float delta) {
+    float* data = writableWeights();
+    for (const Tuple& tuple : tuples) {
+        float* table = data + tuple.offset;
+        for (const auto& cells : tuple.instances) {
+            std::size_t index = 0;
+            for (int i = 0; i < tuple.length; ++i) {
+                index |= static_cast<std::size_t>(std::min(board.getCell(cells[i]), 15)) << (4 * i);
+            }
+            table[index] += delta;
+        }
+    }
+}
+
+float* NTupleNetwork::writableWeights() {
+    if (mappedWeights) {
+        ownedWeights.assign(weights, weights + weightCount);
+        weights = ownedWeights.data();
+        mappedWeights.reset();
+    }
+    return ownedWeights.data();
+}
+
+void NTupleNetwork::save(const std::string& path) const {
+    std::array<std::uint8_t, WEIGHT_HEADER_SIZE> header{};
+    const std::uint32_t version = WEIGHT_FORMAT_VERSION;
+    const std::uint32_t size = static_cast<std::uint32_t>(gridSize);
+    const std::uint64_t count = weightCount;
+    std::memcpy(header.data(), WEIGHT_MAGIC.data(), WEIGHT_MAGIC.size());
+    std::memcpy(header.data() + 8, &version, sizeof(version));
+    std::memcpy(header.data() + 12, &size, sizeof(size));
+    std::memcpy(header.data() + 16, &count, sizeof(count));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    file.write(reinterpret_cast<const char*>(weights), static_cast<std::streamsize>(weightCount * sizeof(float)));
+    if (!file) {
+        throw std::runtime_error("Failed to write weight file: " + path);
+    }
+}
+
+bool NTuplePlayer::chooseMove(const Board& board, Direction& best) const {
+    float bestValue = -std::numeric_limits<float>::infinity();
+    bool found = false;
+    for (Direction dir : board.getDirections()) {
+        Board child = board;
+        if (!child.move(dir)) continue;
+
+        const float value = static_cast<float>(child.getScore() - board.getScore()) + network.evaluate(child);
+        if (!found || value > bestValue) {
+            bestValue = value;
+            best = dir;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void trainNetwork(NTupleNetwork& network, const TrainOptions& options,
+                  const std::function<void(int, double, int)>& progress) {
+    const float alpha = options.learningRate / network.getFeatureCount();
+    const NTuplePlayer player(network);
+
+    double intervalScore = 0.0;
+    int intervalMaxExponent = 0;
+    for (int game = 0; game < options.games; ++game) {
+        Rng rng(Rng::streamSeed(options.seed, static_cast<std::uint64_t>(game)));
+        Board board(network.getGridSize(), options.version);
+        board.addRandomTile(rng);
+        board.addRandomTile(rng);
+
+        Board previous; // 上一步的移动后局面
+        bool hasPrevious = false;
+        Direction dir;
+        while (player.chooseMove(board, dir)) {
+            Board after = board;
+            after.move(dir);
+            if (hasPrevious) {
+                const float reward = static_cast<float>(after.getScore() - board.getScore());
+                const float error = reward + network.evaluate(after) - network.evaluate(previous);
+                network.update(previous, alpha * error);
+            }
+            previous = after;
+            hasPrevious = true;
+
+            board = after;
+            board.addRandomTile(rng);
+        }
+        // 终局之后没有后续收益
+        if (hasPrevious) {
+            network.update(previous, -alpha * network.evaluate(previous));
+        }
+
+        intervalScore += board.getScore();
+        intervalMaxExponent = std::max(intervalMaxExponent, board.getMaxExponent());
+        if (progress && options.reportInterval > 0 && (game + 1) % options.reportInterval == 0) {
+            progress(game + 1, intervalScore / options.reportInterval, intervalMaxExponent);
+            intervalScore = 0.0;
+            intervalMaxExponent = 0;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef NTUPLE_H
+#define NTUPLE_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// n-tuple 网络估值：每个元组是一组固定的格子，格子指数（超过 15 按 15 计）拼成下标查权重表，
+// 估值为所有元组查表之和。同一元组在 8 种旋转/镜像下的像共用一张表。
+// 4x4 使用常见的四个 6 元组；5x5、6x6 使用覆盖全盘的 4 格直线和 2x2 方块
+class NTupleNetwork {
+public:
+    explicit NTupleNetwork(int gridSize); // 全零权重，用于训练
+    // 以只读映射加载权重文件，不拷贝；文件与网络结构不符时抛出 std::runtime_error
+    NTupleNetwork(int gridSize, const std::string& weightsPath);
+
+    int getGridSize() const { return gridSize; }
+    std::size_t getWeightCount() const { return weightCount; }
+
+    float evaluate(const Board& board) const;
+    // 把 board 涉及的每个权重都加上 delta
+    void update(const Board& board, float delta);
+    int getFeatureCount() const { return featureCount; }
+
+    // 权重文件：32 字节文件头（magic "MY2048NT"、格式版本 u32、边长 u32、权重个数 u64、保留 8 字节）
+    // 后接按本机字节序存放的 float 权重，可以直接内存映射使用
+    void save(const std::string& path) const;
+
+private:
+    struct Tuple {
+        std::size_t offset; // 这张表在权重数组中的起点
+        int length;
+        std::vector<std::array<std::uint8_t, 6>> instances; // 8 种对称像的格子顺序
+    };
+
+    int gridSize;
+    std::vector<Tuple> tuples;
+    std::size_t weightCount;
+    int featureCount;
+
+    // 训练时使用自有数组；加载的文件以只读映射提供，第一次 update 时才拷贝出来
+    std::vector<float> ownedWeights;
+    std::unique_ptr<MappedFile> mappedWeights;
+    const float* weights;
+
+    void buildTuples();
+    float* writableWeights();
+};
+
+// 一层贪心：选择 得分 + 估值(移动后的局面) 最大的方向
+class NTuplePlayer {
+public:
+    explicit NTuplePlayer(const NTupleNetwork& network) : network(network) {}
+
+    // 没有可走的方向时返回 false
+    bool chooseMove(const Board& board, Direction& best) const;
+
+private:
+    const NTupleNetwork& network;
+};
+
+struct TrainOptions {
+    GameVersion version = GameVersion::ORIGINAL;
+    int games = 10000;
+    float learningRate = 0.1f;     // 每步的学习率，平均分到所有特征上
+    std::uint64_t seed = 0;        // 第 i 局使用 Rng::streamSeed(seed, i)
+    int reportInterval = 1000;     // 每隔多少局调用一次 progress
+};
+
+// 用 TD(0) 在移动后局面上自我对弈训练：每走一步，用 新得分 + 估值(新的移动后局面) 修正上一个移动后局面的估值。
+// progress(已完成局数, 最近一段的平均得分, 最近一段的最大指数) 可为空
+void trainNetwork(NTupleNetwork& network, const TrainOptions& options,
+                  const std::function<void(int, double, int)>& progress = nullptr);
+
+#endif // NTUPLE_H
@@ -0,0 +1,160 @@
+#include "ReplayAnalysis.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 没有索引时每块包含的记录条数，与索引的间隔相同
+constexpr std::uint64_t RECORDS_PER_CHUNK = record::INDEX_INTERVAL;
+
+struct alignas(64) ReplayWorker {
+    ReplayStats stats;
+    std::size_t badOffset = SIZE_MAX; // 遇到的第一条头部损坏或越过块边界的记录
+};
+
+void analyzeRecord(const record::RecordView& view, Board& board, ReplayStats& stats) {
+    const record::RecordHeader& header = view.header;
+    stats.games += 1;
+    stats.moves += header.moveCount;
+    stats.totalScore += header.score;
+    stats.scoreBuckets[std::bit_width(header.score)] += 1;
+    stats.maxTileCounts[std::min(header.maxExponent, 31)] += 1;
+    for (std::uint32_t i = 0; i < header.moveCount; ++i) {
+        stats.directionCounts[view.body[i] & 7] += 1;
+    }
+
+    // 只有合成过 2048 的局才需要重放，求出第一次合成时的步数
+    if (header.maxExponent < Board::WIN_EXPONENT) {
+        return;
+    }
+    std::uint32_t moves = 0;
+    std::uint32_t winMove = 0;
+    const bool valid = record::replay(view, board, [&](const Board& current, Direction) {
+        ++moves;
+        if (winMove == 0 && current.hasWon()) {
+            winMove = moves;
+        }
+    });
+    if (!valid || winMove == 0) {
+        stats.corrupt += 1;
+        return;
+    }
+    stats.wins += 1;
+    stats.movesToWin += winMove;
+}
+
+// 没有索引时顺序扫描记录头，每 RECORDS_PER_CHUNK 条记下一个块边界，最后一项为文件末尾。只读头部，不解码记录体
+void scanChunks(const std::uint8_t* data, std::size_t size, std::vector<std::size_t>& chunkStarts) {
+    std::size_t offset = record::FILE_HEADER_SIZE;
+    std::uint64_t count = 0;
+    while (offset < size) {
+        record::RecordHeader header;
+        if (size - offset < record::RECORD_HEADER_SIZE || !record::decodeHeader(data + offset, header)) {
+            throw std::runtime_error("Corrupt game record at offset " + std::to_string(offset));
+        }
+        const std::size_t recordSize = record::RECORD_HEADER_SIZE + record::bodySize(header);
+        if (size - offset < recordSize) {
+            throw std::runtime_error("Truncated game record at offset " + std::to_string(offset));
+        }
+        if (count++ % RECORDS_PER_CHUNK == 0) {
+            chunkStarts.push_back(offset);
+        }
+        offset += recordSize;
+    }
+    chunkStarts.push_back(size);
+}
+
+} // namespace
+
+void ReplayStats::merge(const ReplayStats& other) {
+    games += other.games;
+    corrupt += other.corrupt;
+    moves += other.moves;
+    totalScore += other.totalScore;
+    for (std::size_t i = 0; i < scoreBuckets.size(); ++i) {
+        scoreBuckets[i] += other.scoreBuckets[i];
+    }
+    for (std::size_t i = 0; i < maxTileCounts.size(); ++i) {
+        maxTileCounts[i] += other.maxTileCounts[i];
+    }
+    for (std::size_t i = 0; i < directionCounts.size(); ++i) {
+        directionCounts[i] += other.directionCounts[i];
+    }
+    wins += other.wins;
+    movesToWin += other.movesToWin;
+}
+
+ReplayStats analyzeRecords(const std::string& path, int threads) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    const std::uint8_t* data = file.data();
+    const std::size_t size = file.size();
+    if (!record::checkFileHeader(data, size)) {
+        throw std::runtime_error("Not a game record file: " + path);
+    }
+
+    // 正常关闭的文件末尾有索引，直接作为块边界，不再预先扫描；第 1 版文件或写入中断的文件才顺序扫描
+    std::vector<std::size_t> chunkStarts;
+    std::size_t recordsEnd = size;
+    if (record::readIndex(data, size, recordsEnd, chunkStarts)) {
+        chunkStarts.push_back(recordsEnd);
+    } else {
+        chunkStarts.clear();
+        scanChunks(data, size, chunkStarts);
+    }
+
+    const std::size_t chunkCount = chunkStarts.size() - 1;
+    int threadCount = threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threadCount = std::max(1, std::min<int>(threadCount, static_cast<int>(std::max<std::size_t>(chunkCount, 1))));
+
+    // 各线程从共享计数器领取下一块
+    std::atomic<std::size_t> nextChunk{0};
+    std::vector<ReplayWorker> workers(threadCount);
+    auto run = [&](int self) {
+        Board board;
+        ReplayStats& stats = workers[self].stats;
+        for (std::size_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1)) {
+            const std::size_t chunkEnd = chunkStarts[chunk + 1];
+            for (std::size_t at = chunkStarts[chunk]; at < chunkEnd;) {
+                // 按索引分块时记录头没有预先检查过，越过块边界也算损坏
+                record::RecordView view;
+                if (chunkEnd - at < record::RECORD_HEADER_SIZE || !record::decodeHeader(data + at, view.header)
+                    || chunkEnd - at - record::RECORD_HEADER_SIZE < record::bodySize(view.header)) {
+                    workers[self].badOffset = std::min(workers[self].badOffset, at);
+                    break;
+                }
+                view.body = data + at + record::RECORD_HEADER_SIZE;
+                analyzeRecord(view, board, stats);
+                at += record::RECORD_HEADER_SIZE + record::bodySize(view.header);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threadCount; ++i) {
+        pool.emplace_back(run, i);
+    }
+    run(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    ReplayStats total;
+    std::size_t badOffset = SIZE_MAX;
+    for (const ReplayWorker& worker : workers) {
+        total.merge(worker.stats);
+        badOffset = std::min(badOffset, worker.badOffset);
+    }
+    if (badOffset != SIZE_MAX) {
+        throw std::runtime_error("Corrupt game record at offset " + std::to_string(badOffset));
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
@@ -0,0 +1,30 @@
+#ifndef REPLAYANALYSIS_H
+#define REPLAYANALYSIS_H
+
+#include "GameRecord.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// 一批对局记录的汇总；每个线程各自累计，结束后合并
+struct ReplayStats {
+    std::uint64_t games = 0;
+    std::uint64_t corrupt = 0;          // 头部合法但重放与规则不符的记录
+    std::uint64_t moves = 0;
+    std::uint64_t totalScore = 0;
+    std::array<std::uint64_t, 33> scoreBuckets{};  // 第 b 项统计得分在 [2^(b-1), 2^b) 内的局数，第 0 项为 0 分
+    std::array<std::uint64_t, 32> maxTileCounts{}; // 按最大方块的指数统计
+    std::array<std::uint64_t, 8> directionCounts{}; // 按 Direction 统计每个方向被走的次数
+    std::uint64_t wins = 0;             // 合成过 2048 的局数
+    std::uint64_t movesToWin = 0;       // 这些局第一次合成 2048 时的步数之和
+    double seconds = 0.0;
+
+    void merge(const ReplayStats& other);
+};
+
+// 内存映射 path 指向的记录文件，在 threads 个线程上（0 表示全部硬件线程）并行统计。
+// 按文件末尾的索引分块（没有索引的旧文件先顺序扫描记录头），各线程按块领取、检查并重放，
+// 数据始终直接从映射区读取，不拷贝到堆上
+ReplayStats analyzeRecords(const std::string& path, int threads = 0);
+
+#endif // REPLAYANALYSIS_H
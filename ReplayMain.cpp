@@ -0,0 +1,88 @@
+#include "ReplayAnalysis.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// 对局记录统计：My2048Replay games.bin --threads 8
+namespace {
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s FILE [options]\n"
+                "  --threads N        worker threads, 0 = all cores (default 0)\n",
+                program);
+}
+
+const char* directionName(int dir) {
+    static const char* const names[] = {
+        "up", "down", "left", "right", "up-left", "up-right", "down-left", "down-right"
+    };
+    return names[dir];
+}
+
+void printStats(const ReplayStats& stats) {
+    const double games = static_cast<double>(std::max<std::uint64_t>(stats.games, 1));
+    std::printf("games        %llu\n", static_cast<unsigned long long>(stats.games));
+    std::printf("corrupt      %llu\n", static_cast<unsigned long long>(stats.corrupt));
+    std::printf("avg score    %.1f\n", stats.totalScore / games);
+    std::printf("avg moves    %.1f\n", stats.moves / games);
+    std::printf("win rate     %.2f%%\n", 100.0 * stats.wins / games);
+    if (stats.wins > 0) {
+        std::printf("moves to 2048 %.1f (avg over winning games)\n",
+                    static_cast<double>(stats.movesToWin) / stats.wins);
+    }
+    std::printf("elapsed      %.3f s\n", stats.seconds);
+    std::printf("games/s      %.0f\n", stats.games / stats.seconds);
+
+    std::printf("score distribution:\n");
+    for (std::size_t b = 0; b < stats.scoreBuckets.size(); ++b) {
+        if (stats.scoreBuckets[b] == 0) continue;
+        const unsigned long long low = b == 0 ? 0 : 1ULL << (b - 1);
+        const unsigned long long high = b == 0 ? 0 : (1ULL << b) - 1;
+        std::printf("  %8llu - %-8llu  %6.2f%%\n", low, high, 100.0 * stats.scoreBuckets[b] / games);
+    }
+
+    std::printf("max tile distribution:\n");
+    for (std::size_t e = 0; e < stats.maxTileCounts.size(); ++e) {
+        if (stats.maxTileCounts[e] == 0) continue;
+        std::printf("  %8llu  %6.2f%%  (%llu games)\n",
+                    1ULL << e, 100.0 * stats.maxTileCounts[e] / games,
+                    static_cast<unsigned long long>(stats.maxTileCounts[e]));
+    }
+
+    const double moves = static_cast<double>(std::max<std::uint64_t>(stats.moves, 1));
+    std::printf("move directions:\n");
+    for (std::size_t d = 0; d < stats.directionCounts.size(); ++d) {
+        if (stats.directionCounts[d] == 0) continue;
+        std::printf("  %-10s  %6.2f%%\n", directionName(static_cast<int>(d)), 100.0 * stats.directionCounts[d] / moves);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string path;
+    int threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--help") == 0 || !path.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        printStats(analyzeRecords(path, threads));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
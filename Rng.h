@@ -0,0 +1,72 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <cstdint>
+
+// xoshiro256** 伪随机数生成器：状态 32 字节，每次生成只需几次移位和乘法。
+// 同一种子在任何平台上产生相同序列，用来精确重放对局
+class Rng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0) {
+        // 用 splitmix64 展开种子，保证状态不全为零
+        for (std::uint64_t& word : state) {
+            word = splitmix64(seed);
+        }
+    }
+
+    // 由同一个主种子为第 stream 个对局或线程派生互不相关的种子
+    static std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream) {
+        std::uint64_t mixed = seed ^ (stream * 0x9E3779B97F4A7C15ULL);
+        return splitmix64(mixed);
+    }
+
+    result_type next() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // [0, bound) 内的均匀整数（Lemire 乘法取高位，拒绝采样消除偏差）
+    std::uint32_t nextBelow(std::uint32_t bound) {
+        std::uint64_t product = (next() >> 32) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    // 满足 UniformRandomBitGenerator，可以直接交给 <random> 的分布使用
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+    result_type operator()() { return next(); }
+
+private:
+    std::array<std::uint64_t, 4> state;
+
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static std::uint64_t splitmix64(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif // RNG_H
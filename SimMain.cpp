@@ -0,0 +1,216 @@
+#include "BatchRunner.h"
+#include "LargeBoard.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+
+// 无界面批量自我对弈：My2048Sim --games 1000 --size 4 --version original --threads 8
+namespace {
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --games N          number of games to play (default 100)\n"
+                "  --max-moves N      stop each game after N moves, 0 = play to the end (default 0)\n"
+                "  --size N           grid size, 2-64 (default 4); sizes other than 4-6 support only the random player\n"
+                "  --version V        original | diagonal | continuous (default original)\n"
+                "  --threads N        worker threads, 0 = all cores (default 0)\n"
+                "  --player P         expectimax | random | ntuple | montecarlo (default expectimax)\n"
+                "  --depth N          expectimax search depth (default 2)\n"
+                "  --budget-us N      expectimax / montecarlo time budget per move in microseconds (default 0 = no limit)\n"
+                "  --rollouts N       montecarlo rollouts per candidate move (default 100)\n"
+                "  --rollout-policy P random | greedy (default random)\n"
+                "  --rollout-threads N  montecarlo threads per game, 0 = all cores (default 1)\n"
+                "  --seed N           master seed; game i uses stream i of it (default: random)\n"
+                "  --record FILE      write every game to a binary record file\n"
+                "  --record-spawns    also store each spawn's cell and value in the record\n"
+                "  --weights FILE     n-tuple weight file to play with (or to write when training)\n"
+                "  --train N          train the n-tuple network with TD(0) for N games, then save it to --weights\n"
+                "  --learning-rate X  TD(0) learning rate (default 0.1)\n",
+                program);
+}
+
+// 命令行中不属于 BatchOptions 的部分
+struct CommandLine {
+    std::string recordPath;
+    std::string weightsPath;
+    int trainGames = 0;
+    float learningRate = 0.1f;
+};
+
+bool parseArguments(int argc, char** argv, BatchOptions& options, CommandLine& command) {
+    options.search.maxDepth = 2;
+    options.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--help") == 0) {
+            return false;
+        }
+        if (std::strcmp(arg, "--record-spawns") == 0) {
+            options.recordSpawns = true;
+            continue;
+        }
+        if (!value) {
+            std::fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        }
+        ++i;
+
+        if (std::strcmp(arg, "--games") == 0) {
+            options.games = std::atoi(value);
+        } else if (std::strcmp(arg, "--max-moves") == 0) {
+            options.maxMoves = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--size") == 0) {
+            options.gridSize = std::atoi(value);
+        } else if (std::strcmp(arg, "--version") == 0) {
+            if (std::strcmp(value, "original") == 0) {
+                options.version = GameVersion::ORIGINAL;
+            } else if (std::strcmp(value, "diagonal") == 0) {
+                options.version = GameVersion::MODIFIED;
+            } else if (std::strcmp(value, "continuous") == 0) {
+                options.version = GameVersion::CONTINUOUS;
+            } else {
+                std::fprintf(stderr, "Unknown version: %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--player") == 0) {
+            if (std::strcmp(value, "expectimax") == 0) {
+                options.player = PlayerType::EXPECTIMAX;
+            } else if (std::strcmp(value, "random") == 0) {
+                options.player = PlayerType::RANDOM;
+            } else if (std::strcmp(value, "ntuple") == 0) {
+                options.player = PlayerType::NTUPLE;
+            } else if (std::strcmp(value, "montecarlo") == 0) {
+                options.player = PlayerType::MONTECARLO;
+            } else {
+                std::fprintf(stderr, "Unknown player: %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--depth") == 0) {
+            options.search.maxDepth = std::atoi(value);
+        } else if (std::strcmp(arg, "--budget-us") == 0) {
+            options.search.timeBudget = std::chrono::microseconds(std::atoll(value));
+            options.rollout.timeBudget = options.search.timeBudget;
+        } else if (std::strcmp(arg, "--rollouts") == 0) {
+            options.rollout.rolloutsPerMove = std::atoi(value);
+        } else if (std::strcmp(arg, "--rollout-policy") == 0) {
+            if (std::strcmp(value, "random") == 0) {
+                options.rollout.policy = RolloutPolicy::RANDOM;
+            } else if (std::strcmp(value, "greedy") == 0) {
+                options.rollout.policy = RolloutPolicy::GREEDY;
+            } else {
+                std::fprintf(stderr, "Unknown rollout policy: %s\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--rollout-threads") == 0) {
+            options.rollout.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--record") == 0) {
+            command.recordPath = value;
+        } else if (std::strcmp(arg, "--weights") == 0) {
+            command.weightsPath = value;
+        } else if (std::strcmp(arg, "--train") == 0) {
+            command.trainGames = std::atoi(value);
+        } else if (std::strcmp(arg, "--learning-rate") == 0) {
+            command.learningRate = static_cast<float>(std::atof(value));
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg);
+            return false;
+        }
+    }
+
+    if (options.gridSize < LargeBoard::MIN_SIZE || options.gridSize > LargeBoard::MAX_SIZE) {
+        std::fprintf(stderr, "Grid size must be between %d and %d\n", LargeBoard::MIN_SIZE, LargeBoard::MAX_SIZE);
+        return false;
+    }
+    // 菜单以外的尺寸走 LargeBoard，搜索、n-tuple 和对局记录都只支持 4~6
+    if (!movetable::supports(options.gridSize)
+        && (options.player != PlayerType::RANDOM || command.trainGames > 0 || !command.recordPath.empty())) {
+        std::fprintf(stderr, "Grid sizes other than %d-%d support only --player random without --record or --train\n",
+                     movetable::MIN_LENGTH, movetable::MAX_LENGTH);
+        return false;
+    }
+    if ((command.trainGames > 0 || options.player == PlayerType::NTUPLE) && command.weightsPath.empty()) {
+        std::fprintf(stderr, "--weights is required for training and for the ntuple player\n");
+        return false;
+    }
+    return true;
+}
+
+void printStats(const BatchStats& stats) {
+    const double games = static_cast<double>(std::max<std::uint64_t>(stats.games, 1));
+    std::printf("games        %llu\n", static_cast<unsigned long long>(stats.games));
+    std::printf("win rate     %.2f%%\n", 100.0 * stats.wins / games);
+    std::printf("avg score    %.1f\n", stats.totalScore / games);
+    std::printf("best score   %llu\n", static_cast<unsigned long long>(stats.bestScore));
+    std::printf("avg moves    %.1f\n", stats.moves / games);
+    std::printf("elapsed      %.3f s\n", stats.seconds);
+    std::printf("games/s      %.2f\n", stats.games / stats.seconds);
+    std::printf("moves/s      %.0f\n", stats.moves / stats.seconds);
+    std::printf("max tile distribution:\n");
+    for (std::size_t e = 0; e < stats.maxTileCounts.size(); ++e) {
+        if (stats.maxTileCounts[e] == 0) continue;
+        std::printf("  %8llu  %6.2f%%  (%llu games)\n",
+                    1ULL << e, 100.0 * stats.maxTileCounts[e] / games,
+                    static_cast<unsigned long long>(stats.maxTileCounts[e]));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BatchOptions options;
+    CommandLine command;
+    if (!parseArguments(argc, argv, options, command)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        // 训练模式：TD(0) 自我对弈后保存权重
+        if (command.trainGames > 0) {
+            NTupleNetwork network(options.gridSize);
+            TrainOptions train;
+            train.version = options.version;
+            train.games = command.trainGames;
+            train.learningRate = command.learningRate;
+            train.seed = options.seed;
+            std::printf("seed         %llu\n", static_cast<unsigned long long>(options.seed));
+            std::printf("weights      %zu\n", network.getWeightCount());
+            trainNetwork(network, train, [](int games, double averageScore, int maxExponent) {
+                std::printf("%10d games  avg score %10.1f  max tile %llu\n", games, averageScore, 1ULL << maxExponent);
+                std::fflush(stdout);
+            });
+            network.save(command.weightsPath);
+            return 0;
+        }
+
+        std::unique_ptr<NTupleNetwork> network;
+        if (options.player == PlayerType::NTUPLE) {
+            network = std::make_unique<NTupleNetwork>(options.gridSize, command.weightsPath);
+            options.network = network.get();
+        }
+
+        std::unique_ptr<record::RecordWriter> recorder;
+        if (!command.recordPath.empty()) {
+            recorder = std::make_unique<record::RecordWriter>(command.recordPath);
+            options.recorder = recorder.get();
+        }
+
+        std::printf("seed         %llu\n", static_cast<unsigned long long>(options.seed));
+        printStats(runBatch(options));
+        if (recorder) {
+            recorder->close();
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
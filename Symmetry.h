@@ -0,0 +1,41 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "Direction.h"
+#include <utility>
+
+// 正方形棋盘的 8 种旋转/镜像。编号 s 的三个位依次表示：先按 TRANSPOSE 沿主对角线翻转，
+// 再按 FLIP_X 左右翻转、按 FLIP_Y 上下翻转。两个版本的规则在这 8 种变换下都不变，
+// 变换前走 dir 等价于变换后走 transformDirection(dir, s)
+namespace symmetry {
+
+constexpr int COUNT = 8;
+constexpr int FLIP_X = 1;
+constexpr int FLIP_Y = 2;
+constexpr int TRANSPOSE = 4;
+
+inline std::pair<int, int> transformPoint(int s, int x, int y, int size) {
+    if (s & TRANSPOSE) std::swap(x, y);
+    if (s & FLIP_X) x = size - 1 - x;
+    if (s & FLIP_Y) y = size - 1 - y;
+    return {x, y};
+}
+
+inline Direction transformDirection(Direction dir, int s) {
+    int dx = directionDx(dir);
+    int dy = directionDy(dir);
+    if (s & TRANSPOSE) std::swap(dx, dy);
+    if (s & FLIP_X) dx = -dx;
+    if (s & FLIP_Y) dy = -dy;
+    return directionFromDelta(dx, dy);
+}
+
+// 逆变换：不含转置时每种翻转都是自身的逆；含转置时两个翻转互换
+inline int inverse(int s) {
+    if (!(s & TRANSPOSE)) return s;
+    return TRANSPOSE | ((s & FLIP_X) ? FLIP_Y : 0) | ((s & FLIP_Y) ? FLIP_X : 0);
+}
+
+} // namespace symmetry
+
+#endif // SYMMETRY_H
@@ -1,7 +1,54 @@
 #include "Game2048.h"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
 
-int main() {
-    Game game;
+int main(int argc, char** argv) {
+    // --seed N 固定随机种子以便重放，默认每次启动随机
+    std::uint64_t seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    // --fps N 设置帧率上限（0 为不限），--vsync 改用垂直同步
+    DisplayOptions display;
+    std::string recordPath;
+    std::string weightsPath;
+    int weightsSize = 4;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            display.frameLimit = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--vsync") == 0) {
+            display.verticalSync = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            // --trace FILE 退出时（以及按 F4 时）把最近的帧写成 Chrome trace，--trace-frames N 设置保留的帧数
+            display.tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace-frames") == 0 && i + 1 < argc) {
+            display.traceFrames = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--weights") == 0 && i + 2 < argc) {
+            weightsSize = std::atoi(argv[++i]);
+            weightsPath = argv[++i];
+        }
+    }
+
+    // --weights SIZE FILE 让该尺寸棋盘的自动玩家使用训练好的 n-tuple 网络
+    std::unique_ptr<NTupleNetwork> network;
+    if (!weightsPath.empty()) {
+        network = std::make_unique<NTupleNetwork>(weightsSize, weightsPath);
+    }
+
+    // --record FILE 把每一局写入二进制对局记录
+    std::unique_ptr<record::RecordWriter> recorder;
+    if (!recordPath.empty()) {
+        recorder = std::make_unique<record::RecordWriter>(recordPath);
+    }
+
+    Game game(seed, display, recorder.get(), network.get());
     game.run();
+    if (recorder) {
+        recorder->close();
+    }
     return 0;
 }
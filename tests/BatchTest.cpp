@@ -0,0 +1,80 @@
+#include "Bitboard.h"
+#include "Rng.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// 批量移动与批量结束判断（AVX2 或逐个调用）和 bitboard::move / isGameOver 逐个比较
+namespace {
+
+// 指数取值范围小时相邻相同的方块多，合并和结束判断的各种情况都能覆盖到；也混入 15 检查不再合并
+Bitboard randomBoard(Rng& rng) {
+    const std::uint32_t range = 2 + rng.nextBelow(15);
+    const std::uint32_t emptyChance = rng.nextBelow(4);
+    Bitboard board = 0;
+    for (int cell = 0; cell < 16; ++cell) {
+        if (rng.nextBelow(4) < emptyChance) continue;
+        const Bitboard exponent = rng.nextBelow(8) == 0 ? 15 : 1 + rng.nextBelow(range);
+        board |= std::min<Bitboard>(exponent, 15) << (4 * cell);
+    }
+    return board;
+}
+
+} // namespace
+
+int main() {
+    std::printf("batch kernel: %s\n", bitboard::batchKernel());
+
+    Rng rng(19);
+    const Direction directions[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    // 不是 4 的倍数的数量检查向量化后剩下的尾部
+    for (std::size_t count : {std::size_t(0), std::size_t(1), std::size_t(3), std::size_t(4), std::size_t(7),
+                              std::size_t(33), std::size_t(4099)}) {
+        std::vector<Bitboard> boards(count);
+        for (Bitboard& board : boards) {
+            board = randomBoard(rng);
+        }
+
+        for (Direction dir : directions) {
+            std::vector<Bitboard> results(count);
+            std::vector<std::uint32_t> scores(count);
+            std::vector<std::uint8_t> moved(count);
+            bitboard::moveBatch(boards.data(), count, dir, results.data(), scores.data(), moved.data());
+
+            // results 就是 boards 时原地移动
+            std::vector<Bitboard> inPlace = boards;
+            std::vector<std::uint32_t> inPlaceScores(count);
+            std::vector<std::uint8_t> inPlaceMoved(count);
+            bitboard::moveBatch(inPlace.data(), count, dir, inPlace.data(), inPlaceScores.data(), inPlaceMoved.data());
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const bitboard::MoveResult expected = bitboard::move(boards[i], dir);
+                CHECK(results[i] == expected.board);
+                CHECK(scores[i] == static_cast<std::uint32_t>(expected.score));
+                CHECK((moved[i] != 0) == expected.moved);
+                CHECK(inPlace[i] == expected.board);
+                CHECK(inPlaceScores[i] == scores[i]);
+                CHECK(inPlaceMoved[i] == moved[i]);
+            }
+        }
+
+        std::vector<std::uint8_t> over(count);
+        bitboard::gameOverBatch(boards.data(), count, over.data());
+        for (std::size_t i = 0; i < count; ++i) {
+            CHECK((over[i] != 0) == bitboard::isGameOver(boards[i]));
+        }
+    }
+
+    // 满盘且无相邻相同方块时结束，放进一批里检查结束的分支确实被走到
+    const Bitboard stuck = 0x1212212112122121ULL;
+    std::vector<Bitboard> mixed(9, stuck);
+    mixed[4] = 0;
+    std::vector<std::uint8_t> over(mixed.size());
+    bitboard::gameOverBatch(mixed.data(), mixed.size(), over.data());
+    for (std::size_t i = 0; i < mixed.size(); ++i) {
+        CHECK((over[i] != 0) == (i != 4));
+    }
+
+    return test::testResult();
+}
@@ -0,0 +1,123 @@
+#include "Bitboard.h"
+#include "MoveTables.h"
+#include "Rng.h"
+#include "TestCheck.h"
+#include <array>
+
+// 行表与逐格模拟比较：原版和连续合并两种规则，4、5 格逐行、6 格抽查；再抽查 4x4 位棋盘的连续合并
+namespace {
+
+struct Expected {
+    movetable::Line line = 0;
+    int score = 0;
+    std::uint8_t mergeMask = 0;
+};
+
+// 逐格左移。两个 32768（指数 15）与表一致不再合并
+Expected slideLeft(movetable::Line line, int length, movetable::MergeRule rule) {
+    std::array<int, movetable::MAX_LENGTH> values{};
+    std::array<bool, movetable::MAX_LENGTH> merged{};
+    int count = 0;
+    Expected result;
+    for (int i = 0; i < length; ++i) {
+        const int exponent = static_cast<int>((line >> (4 * i)) & 0xF);
+        if (exponent == 0) continue;
+        if (rule == movetable::MergeRule::STANDARD) {
+            if (count > 0 && !merged[count - 1] && values[count - 1] == exponent && exponent < 15) {
+                ++values[count - 1];
+                merged[count - 1] = true;
+                result.score += 1 << values[count - 1];
+            } else {
+                values[count] = exponent;
+                merged[count++] = false;
+            }
+            continue;
+        }
+        values[count] = exponent;
+        merged[count++] = false;
+        while (count >= 2 && values[count - 1] == values[count - 2] && values[count - 1] < 15) {
+            --count;
+            ++values[count - 1];
+            merged[count - 1] = true;
+            result.score += 1 << values[count - 1];
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        result.line |= static_cast<movetable::Line>(values[i]) << (4 * i);
+        result.mergeMask |= static_cast<std::uint8_t>(merged[i] ? 1u << i : 0u);
+    }
+    return result;
+}
+
+// 每隔 step 行检查一行；step 与 16 互素，各格的取值都会轮到
+void checkTable(int length, movetable::MergeRule rule, movetable::Line step) {
+    const movetable::LineTable& table = movetable::table(length, rule);
+    CHECK(table.getLength() == length);
+    CHECK(table.getRule() == rule);
+    const movetable::Line count = movetable::Line(1) << (4 * length);
+    for (movetable::Line line = 0; line < count; line += step) {
+        const Expected expected = slideLeft(line, length, rule);
+        const movetable::LineMove left = table.left(line);
+        CHECK(left.line == expected.line);
+        CHECK(left.score == expected.score);
+        CHECK(left.mergeMask == expected.mergeMask);
+        CHECK(left.moved == (expected.line != line));
+
+        // 右移是翻转后的左移，左移已逐行核对过
+        const movetable::LineMove right = table.right(line);
+        const movetable::LineMove mirrored = table.left(movetable::reverse(line, length));
+        CHECK(right.line == movetable::reverse(mirrored.line, length));
+        CHECK(right.score == mirrored.score);
+        CHECK(table.canMove(line) == (left.moved || right.moved));
+    }
+}
+
+} // namespace
+
+int main() {
+    for (int length = movetable::MIN_LENGTH; length <= movetable::MAX_LENGTH; ++length) {
+        // 6 格有 1600 多万行，抽查其中七分之一
+        const movetable::Line step = length == movetable::MAX_LENGTH ? 7 : 1;
+        checkTable(length, movetable::MergeRule::STANDARD, step);
+        checkTable(length, movetable::MergeRule::CHAIN, step);
+    }
+
+    // README 里的例子：2 2 4 左移得 8，得分 4 + 8
+    const movetable::LineMove example = movetable::table(4, movetable::MergeRule::CHAIN).left(0x211);
+    CHECK(example.line == 0x3);
+    CHECK(example.score == 12);
+
+    // 位棋盘的连续合并按行查表，上下移动经转置，与逐行模拟一致；指数不超过 13，结果不会超出 4 bit
+    Rng rng(24);
+    for (int i = 0; i < 20000; ++i) {
+        Bitboard board = 0;
+        for (int cell = 0; cell < 16; ++cell) {
+            if (rng.nextBelow(3) != 0) {
+                board |= static_cast<Bitboard>(1 + rng.nextBelow(4 + i % 10)) << (4 * cell);
+            }
+        }
+        for (Direction dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+            const bool vertical = dir == Direction::UP || dir == Direction::DOWN;
+            const bool towardStart = dir == Direction::UP || dir == Direction::LEFT;
+            const Bitboard rows = vertical ? bitboard::transpose(board) : board;
+            Bitboard expected = 0;
+            int score = 0;
+            for (int y = 0; y < 4; ++y) {
+                movetable::Line line = static_cast<movetable::Line>((rows >> (16 * y)) & 0xFFFF);
+                if (!towardStart) line = movetable::reverse(line, 4);
+                const Expected slid = slideLeft(line, 4, movetable::MergeRule::CHAIN);
+                const movetable::Line result = towardStart ? slid.line : movetable::reverse(slid.line, 4);
+                expected |= static_cast<Bitboard>(result) << (16 * y);
+                score += slid.score;
+            }
+            if (vertical) expected = bitboard::transpose(expected);
+
+            const bitboard::MoveResult result = bitboard::moveChain(board, dir);
+            CHECK(result.board == expected);
+            CHECK(result.score == score);
+            CHECK(result.moved == (expected != board));
+        }
+    }
+
+    return test::testResult();
+}
@@ -0,0 +1,234 @@
+#include "Board.h"
+#include "LargeBoard.h"
+#include "Rng.h"
+#include "TestCheck.h"
+#include <vector>
+
+// LargeBoard 的差分测试：4~6 格与 Board 逐步对照，2~64 格与逐格实现的参照规则对照
+namespace {
+
+constexpr GameVersion VERSIONS[] = {GameVersion::ORIGINAL, GameVersion::MODIFIED, GameVersion::CONTINUOUS};
+
+// 参照实现：按行优先存指数，每个方向按紧贴墙的起点逐条线滑动，不做任何优化
+struct Reference {
+    int size;
+    GameVersion version;
+    std::vector<int> cells;
+    std::uint64_t score = 0;
+
+    Reference(const LargeBoard& board)
+        : size(board.getSize()), version(board.getVersion()), cells(board.getCellCount()) {
+        for (int cell = 0; cell < board.getCellCount(); ++cell) {
+            cells[cell] = board.getCell(cell);
+        }
+    }
+
+    bool inside(int x, int y) const { return x >= 0 && x < size && y >= 0 && y < size; }
+
+    bool move(Direction dir) {
+        const int dx = directionDx(dir);
+        const int dy = directionDy(dir);
+        const bool chain = version == GameVersion::CONTINUOUS;
+        bool moved = false;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (inside(x + dx, y + dy)) continue;
+                std::vector<int> line;
+                for (int cx = x, cy = y; inside(cx, cy); cx -= dx, cy -= dy) {
+                    line.push_back(cells[cy * size + cx]);
+                }
+
+                std::vector<int> result;
+                bool lastMerged = false;
+                for (int exponent : line) {
+                    if (exponent == 0) continue;
+                    if (chain) {
+                        result.push_back(exponent);
+                        while (result.size() >= 2 && result[result.size() - 1] == result[result.size() - 2]) {
+                            result.pop_back();
+                            score += std::uint64_t(1) << ++result.back();
+                        }
+                    } else if (!result.empty() && !lastMerged && result.back() == exponent) {
+                        score += std::uint64_t(1) << ++result.back();
+                        lastMerged = true;
+                    } else {
+                        result.push_back(exponent);
+                        lastMerged = false;
+                    }
+                }
+                result.resize(line.size(), 0);
+
+                int i = 0;
+                for (int cx = x, cy = y; inside(cx, cy); cx -= dx, cy -= dy, ++i) {
+                    moved = moved || cells[cy * size + cx] != result[i];
+                    cells[cy * size + cx] = result[i];
+                }
+            }
+        }
+        return moved;
+    }
+
+    // 空棋盘不算结束，否则看这个版本的四个方向是否都无法移动。斜向版本里方块只占一种棋盘格颜色时
+    // 有空格也走不动，同样算结束
+    bool isGameOver() const {
+        bool empty = true;
+        for (int exponent : cells) {
+            empty = empty && exponent == 0;
+        }
+        if (empty) return false;
+        for (Direction dir : versionDirections(version)) {
+            Reference copy = *this;
+            if (copy.move(dir)) return false;
+        }
+        return true;
+    }
+};
+
+void checkSame(const LargeBoard& board, const Reference& reference) {
+    bool same = true;
+    for (int cell = 0; cell < board.getCellCount(); ++cell) {
+        same = same && board.getCell(cell) == reference.cells[cell];
+    }
+    CHECK(same);
+    CHECK(board.getScore() == reference.score);
+}
+
+void checkSame(const LargeBoard& large, const Board& board) {
+    bool same = true;
+    for (int cell = 0; cell < board.getCellCount(); ++cell) {
+        same = same && large.getCell(cell) == board.getCell(cell);
+    }
+    CHECK(same);
+    CHECK(large.getScore() == static_cast<std::uint64_t>(board.getScore()));
+    CHECK(large.getEmptyCount() == board.getEmptyCount());
+    CHECK(large.hasWon() == board.hasWon());
+    CHECK(large.isGameOver() == board.isGameOver());
+}
+
+// 随机摆一个局面：密度和指数范围各不相同，指数范围小时相邻相同的方块多；偶尔用到 Board 行表以外的大指数
+void randomFill(LargeBoard& board, Rng& rng) {
+    const std::uint32_t emptyChance = rng.nextBelow(5);
+    const std::uint32_t range = 1 + rng.nextBelow(rng.nextBelow(4) == 0 ? 20 : 4);
+    for (int cell = 0; cell < board.getCellCount(); ++cell) {
+        board.setCell(cell, rng.nextBelow(4) < emptyChance ? 0 : static_cast<int>(1 + rng.nextBelow(range)));
+    }
+}
+
+// 4~6 格：同一种子的随机对局逐步一致，包括生成方块的位置
+void compareWithBoard(int size, GameVersion version, std::uint64_t seed) {
+    LargeBoard large(size, version);
+    Board board(size, version);
+    Rng largeRng(seed);
+    Rng boardRng(seed);
+    Rng playerRng(Rng::streamSeed(seed, 1));
+    for (int i = 0; i < 2; ++i) {
+        CHECK(large.addRandomTile(largeRng) == board.addRandomTile(boardRng));
+    }
+    checkSame(large, board);
+
+    while (!board.isGameOver()) {
+        for (Direction dir : board.getDirections()) {
+            CHECK(large.canMove(dir) == board.canMove(dir));
+        }
+        const Direction dir = board.getDirections()[playerRng.nextBelow(4)];
+        const bool moved = board.move(dir);
+        CHECK(large.move(dir) == moved);
+        if (moved) {
+            CHECK(large.addRandomTile(largeRng) == board.addRandomTile(boardRng));
+        }
+        checkSame(large, board);
+    }
+
+    // 任意局面（含大方块）各方向走一步
+    for (int i = 0; i < 200; ++i) {
+        randomFill(large, playerRng);
+        for (int cell = 0; cell < board.getCellCount(); ++cell) {
+            board.setCell(cell, large.getCell(cell));
+        }
+        checkSame(large, board);
+        for (Direction dir : board.getDirections()) {
+            LargeBoard largeChild = large;
+            Board boardChild = board;
+            CHECK(largeChild.move(dir) == boardChild.move(dir));
+            CHECK(largeChild.getScore() - large.getScore()
+                  == static_cast<std::uint64_t>(boardChild.getScore() - board.getScore()));
+            bool same = true;
+            for (int cell = 0; cell < board.getCellCount(); ++cell) {
+                same = same && largeChild.getCell(cell) == boardChild.getCell(cell);
+            }
+            CHECK(same);
+        }
+    }
+}
+
+// 2~64 格：随机局面上每个方向的移动、能否移动和结束判断都与参照实现一致，再随机走一段
+void compareWithReference(int size, GameVersion version, Rng& rng) {
+    LargeBoard board(size, version);
+    CHECK(!board.isGameOver());
+
+    const int positions = size <= 16 ? 40 : 8;
+    for (int i = 0; i < positions; ++i) {
+        board.reset();
+        randomFill(board, rng);
+        const Reference reference(board);
+        CHECK(board.isGameOver() == reference.isGameOver());
+        for (Direction dir : board.getDirections()) {
+            LargeBoard child = board;
+            Reference expected = reference;
+            const bool moved = expected.move(dir);
+            CHECK(board.canMove(dir) == moved);
+            CHECK(child.move(dir) == moved);
+            checkSame(child, expected);
+        }
+    }
+
+    // 满盘且没有相邻相同方块（棋盘格着色）时结束；斜向版本沿斜线方向交替
+    board.reset();
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const int parity = version == GameVersion::MODIFIED ? y % 2 : (x + y) % 2;
+            board.setCell(y * size + x, 1 + parity);
+        }
+    }
+    CHECK(board.isGameOver() == Reference(board).isGameOver());
+    CHECK(board.isGameOver());
+
+    board.reset();
+    Reference reference(board);
+    auto spawn = [&]() {
+        const int cell = board.addRandomTile(rng);
+        CHECK(cell >= 0);
+        if (cell >= 0) reference.cells[cell] = board.getCell(cell);
+    };
+    spawn();
+    spawn();
+    const int moves = size <= 16 ? 500 : 100;
+    for (int i = 0; i < moves && !board.isGameOver(); ++i) {
+        const Direction dir = board.getDirections()[rng.nextBelow(4)];
+        const bool moved = reference.move(dir);
+        CHECK(board.move(dir) == moved);
+        checkSame(board, reference);
+        if (moved) spawn();
+    }
+}
+
+} // namespace
+
+int main() {
+    for (int size = movetable::MIN_LENGTH; size <= movetable::MAX_LENGTH; ++size) {
+        for (GameVersion version : VERSIONS) {
+            for (std::uint64_t seed = 1; seed <= 5; ++seed) {
+                compareWithBoard(size, version, Rng::streamSeed(25, seed * 16 + size));
+            }
+        }
+    }
+
+    Rng rng(25);
+    for (int size = LargeBoard::MIN_SIZE; size <= LargeBoard::MAX_SIZE; ++size) {
+        for (GameVersion version : VERSIONS) {
+            compareWithReference(size, version, rng);
+        }
+    }
+
+    return test::testResult();
+}
@@ -0,0 +1,104 @@
+#include "GameRecord.h"
+#include "ReplayAnalysis.h"
+#include "TestCheck.h"
+#include <filesystem>
+#include <vector>
+
+// 对局记录往返：写出的每一局按原样读回，按种子重放得到相同的终局，并行统计与逐局累计一致
+namespace {
+
+record::GameRecord playGame(int size, GameVersion version, std::uint64_t seed, bool withSpawns) {
+    Rng rng(seed);
+    Rng playerRng(Rng::streamSeed(seed, 1));
+    Board board(size, version);
+    record::GameRecord game;
+    game.begin(size, version, seed, withSpawns);
+    auto spawn = [&]() {
+        const int cell = board.addRandomTile(rng);
+        game.addSpawn(cell, board.getCell(cell));
+    };
+    spawn();
+    spawn();
+    while (!board.isGameOver()) {
+        const Direction dir = board.getDirections()[playerRng.nextBelow(4)];
+        if (!board.move(dir)) continue;
+        game.addMove(dir);
+        spawn();
+    }
+    game.finish(board);
+    return game;
+}
+
+} // namespace
+
+int main() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "my2048_record_test.bin";
+
+    std::vector<record::GameRecord> games;
+    const GameVersion versions[] = {GameVersion::ORIGINAL, GameVersion::MODIFIED, GameVersion::CONTINUOUS};
+    for (int i = 0; i < 60; ++i) {
+        games.push_back(playGame(4 + i % 3, versions[(i / 3) % 3], Rng::streamSeed(2048, i), i % 2 == 0));
+    }
+    {
+        // 缓冲区比一局还小，每局都要跨过多次落盘
+        record::RecordWriter writer(path.string(), 256);
+        for (const record::GameRecord& game : games) {
+            writer.write(game);
+        }
+        writer.close();
+    }
+
+    record::RecordReader reader(path.string(), 128);
+    record::RecordView view;
+    std::size_t count = 0;
+    std::uint64_t totalMoves = 0;
+    std::uint64_t totalScore = 0;
+    while (reader.next(view)) {
+        CHECK(count < games.size());
+        if (count >= games.size()) break;
+        const record::GameRecord& game = games[count++];
+        CHECK(view.header.gridSize == game.header.gridSize);
+        CHECK(view.header.version == game.header.version);
+        CHECK(view.header.flags == game.header.flags);
+        CHECK(view.header.seed == game.header.seed);
+        CHECK(view.header.score == game.header.score);
+        CHECK(view.header.maxExponent == game.header.maxExponent);
+        CHECK(view.header.moveCount == game.moves.size());
+        CHECK(view.hasSpawns() == !game.spawns.empty());
+        for (std::uint32_t m = 0; m < view.header.moveCount && m < game.moves.size(); ++m) {
+            CHECK(view.move(m) == static_cast<Direction>(game.moves[m]));
+        }
+        if (view.hasSpawns()) {
+            for (std::uint32_t s = 0; s < game.spawns.size(); ++s) {
+                CHECK(view.spawn(s) == game.spawns[s]);
+            }
+        }
+
+        // 只凭种子和方向重放
+        Board board(view.header.gridSize, view.header.version);
+        Rng rng(view.header.seed);
+        board.addRandomTile(rng);
+        board.addRandomTile(rng);
+        for (std::uint32_t m = 0; m < view.header.moveCount; ++m) {
+            CHECK(board.move(view.move(m)));
+            board.addRandomTile(rng);
+        }
+        CHECK(board.isGameOver());
+        CHECK(static_cast<std::uint32_t>(board.getScore()) == view.header.score);
+        CHECK(board.getMaxExponent() == view.header.maxExponent);
+
+        totalMoves += view.header.moveCount;
+        totalScore += view.header.score;
+    }
+    CHECK(count == games.size());
+
+    // 带索引的文件由内存映射并行统计
+    const ReplayStats stats = analyzeRecords(path.string(), 4);
+    CHECK(stats.games == games.size());
+    CHECK(stats.corrupt == 0);
+    CHECK(stats.moves == totalMoves);
+    CHECK(stats.totalScore == totalScore);
+
+    std::filesystem::remove(path);
+    return test::testResult();
+}
@@ -0,0 +1,33 @@
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+#include <cstdio>
+
+// 行为测试共用的检查：失败时打印位置并计数，main 最后用 testResult() 作为退出码，
+// 一次运行能报告所有不一致的地方
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline int testResult() {
+    if (failures() != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace test
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++test::failures();                                                           \
+        }                                                                                 \
+    } while (false)
+
+#endif // TESTCHECK_H